@@ -278,6 +278,16 @@ def _api_add_friend_py(a: int, b: int):
     fn.restype = ctypes.c_bool
     return bool(fn(c_int(a), c_int(b)))
 
+def _api_add_friends_bulk_py(edges):
+    fn = resolve_symbol('_api_add_friends_bulk') or resolve_symbol('api_add_friends_bulk')
+    if not fn:
+        raise RuntimeError('_api_add_friends_bulk not found')
+    flat = [int(x) for e in edges for x in e[:2]]
+    arr = (c_int * max(len(flat), 1))(*flat)
+    fn.argtypes = [ctypes.POINTER(c_int), c_int]
+    fn.restype = c_int
+    return int(fn(arr, len(flat) // 2))
+
 def _api_remove_friend_py(a: int, b: int):
     fn = resolve_symbol('_api_remove_friend') or resolve_symbol('api_remove_friend')
     if not fn:
@@ -324,6 +334,39 @@ def _api_recommend_weighted_py(uid: int, k: int):
         raise RuntimeError('_api_recommend_weighted not found')
     return call_mixed_str_or_int(fn, uid, k)
 
+def _api_recommend_scored_py(uid: int, k: int, strategy: str):
+    fn = resolve_symbol('_api_recommend_scored') or resolve_symbol('api_recommend_scored')
+    if not fn:
+        raise RuntimeError('_api_recommend_scored not found')
+    return call_str(fn, uid, k, strategy)
+
+def _api_recommend_filtered_py(uid: int, k: int, strategy: str, exclude: str, interests: str):
+    fn = resolve_symbol('_api_recommend_filtered') or resolve_symbol('api_recommend_filtered')
+    if not fn:
+        raise RuntimeError('_api_recommend_filtered not found')
+    return call_str(fn, uid, k, strategy, exclude, interests)
+
+def _api_search_interests_py(all_csv: str, any_csv: str, none_csv: str, k: int):
+    fn = resolve_symbol('_api_search_interests') or resolve_symbol('api_search_interests')
+    if not fn:
+        raise RuntimeError('_api_search_interests not found')
+    return call_str(fn, all_csv, any_csv, none_csv, k)
+
+def _api_changes_since_py(seq: int, max_events: int):
+    fn = resolve_symbol('_api_changes_since') or resolve_symbol('api_changes_since')
+    if not fn:
+        raise RuntimeError('_api_changes_since not found')
+    # seq is 64-bit, so set argtypes instead of going through call_str
+    fn.argtypes = [ctypes.c_longlong, c_int]
+    fn.restype = c_void_p
+    res = fn(int(seq), int(max_events))
+    if not res:
+        return None
+    try:
+        return ctypes.string_at(res).decode('utf-8', errors='replace')
+    finally:
+        _free_string(res)
+
 def _api_shortest_path_py(a: int, b: int):
     fn = resolve_symbol('_api_shortest_path') or resolve_symbol('api_shortest_path')
     if not fn:
@@ -336,6 +379,40 @@ def _api_connected_components_py():
         raise RuntimeError('_api_connected_components not found')
     return call_str(fn)
 
+def _api_communities_py(min_size: int):
+    fn = resolve_symbol('_api_communities') or resolve_symbol('api_communities')
+    if not fn:
+        raise RuntimeError('_api_communities not found')
+    return call_str(fn, min_size)
+
+def _api_submit_job_py(kind: str, params: str):
+    fn = resolve_symbol('_api_submit_job') or resolve_symbol('api_submit_job')
+    if not fn:
+        raise RuntimeError('_api_submit_job not found')
+    fn.argtypes = [c_char_p, c_char_p]
+    fn.restype = c_int
+    return int(fn(kind.encode('utf-8'), params.encode('utf-8')))
+
+def _api_job_status_py(job_id: int):
+    fn = resolve_symbol('_api_job_status') or resolve_symbol('api_job_status')
+    if not fn:
+        raise RuntimeError('_api_job_status not found')
+    return call_str(fn, job_id)
+
+def _api_job_cancel_py(job_id: int):
+    fn = resolve_symbol('_api_job_cancel') or resolve_symbol('api_job_cancel')
+    if not fn:
+        raise RuntimeError('_api_job_cancel not found')
+    fn.argtypes = [c_int]
+    fn.restype = ctypes.c_bool
+    return bool(fn(c_int(job_id)))
+
+def _api_job_result_py(job_id: int):
+    fn = resolve_symbol('_api_job_result') or resolve_symbol('api_job_result')
+    if not fn:
+        raise RuntimeError('_api_job_result not found')
+    return call_str(fn, job_id)
+
 def _api_suggest_prefix_py(prefix: str, k: int):
     fn = resolve_symbol('_api_suggest_prefix') or resolve_symbol('api_suggest_prefix')
     if not fn:
@@ -431,6 +508,21 @@ def api_add_friend():
     except Exception as e:
         return fail(e)
 
+@app.route('/api/add_friends_bulk', methods=['POST'])
+def api_add_friends_bulk():
+    if lib is None:
+        return lib_missing()
+    try:
+        # {"edges": [[a, b], ...]}
+        body = request.json or {}
+        edges = [e for e in body.get('edges', []) if isinstance(e, (list, tuple)) and len(e) >= 2]
+        res = _api_add_friends_bulk_py(edges)
+        if res < 0:
+            return fail('invalid edge list', 400)
+        return ok({'added': res})
+    except Exception as e:
+        return fail(e)
+
 @app.route('/api/remove_friend', methods=['POST'])
 def api_remove_friend():
     if lib is None:
@@ -499,13 +591,76 @@ def api_recommend_weighted(uid, k):
     except Exception as e:
         return fail(e)
 
+@app.route('/api/recommend/<strategy>/<int:uid>/<int:k>', methods=['GET'])
+def api_recommend_scored(strategy, uid, k):
+    if lib is None:
+        return lib_missing()
+    try:
+        # ?exclude=1,2,3&interests=a,b are applied before the top-k cut
+        exclude = request.args.get('exclude', '')
+        interests = request.args.get('interests', '')
+        if exclude or interests:
+            s = _api_recommend_filtered_py(uid, k, strategy, exclude, interests)
+        else:
+            s = _api_recommend_scored_py(uid, k, strategy)
+        return ok({'strategy': strategy, 'recommendations': try_parse_json(s)})
+    except Exception as e:
+        return fail(e)
+
 @app.route('/api/communities', methods=['GET'])
 def api_communities():
     if lib is None:
         return lib_missing()
     try:
-        s = _api_connected_components_py()
-        return ok({'communities': try_parse_json(s)})
+        # ?mode=components keeps the old connected-components view
+        if request.args.get('mode') == 'components':
+            s = _api_connected_components_py()
+            return ok({'communities': try_parse_json(s)})
+        min_size = int(request.args.get('min_size', 1))
+        res = try_parse_json(_api_communities_py(min_size))
+        if not isinstance(res, dict):
+            return ok({'communities': res})
+        return ok({'communities': res.get('communities', []),
+                   'modularity': res.get('modularity'),
+                   'levels': res.get('levels')})
+    except Exception as e:
+        return fail(e)
+
+@app.route('/api/jobs', methods=['POST'])
+def api_submit_job():
+    if lib is None:
+        return lib_missing()
+    try:
+        body = request.json or {}
+        kind = str(body.get('kind', ''))
+        params = body.get('params', {}) or {}
+        if isinstance(params, dict):
+            params = '&'.join('%s=%s' % (k, v) for k, v in params.items())
+        job_id = _api_submit_job_py(kind, str(params))
+        if job_id < 0:
+            return fail('unknown job kind: %s' % kind, 400)
+        return ok({'job': job_id})
+    except Exception as e:
+        return fail(e)
+
+@app.route('/api/jobs/<int:job_id>', methods=['GET'])
+def api_job_status(job_id):
+    if lib is None:
+        return lib_missing()
+    try:
+        status = try_parse_json(_api_job_status_py(job_id))
+        if isinstance(status, dict) and status.get('status') == 'done':
+            status['result'] = try_parse_json(_api_job_result_py(job_id))
+        return ok(status)
+    except Exception as e:
+        return fail(e)
+
+@app.route('/api/jobs/<int:job_id>', methods=['DELETE'])
+def api_job_cancel(job_id):
+    if lib is None:
+        return lib_missing()
+    try:
+        return ok({'cancelled': _api_job_cancel_py(job_id)})
     except Exception as e:
         return fail(e)
 
@@ -561,6 +716,37 @@ def api_suggest(prefix, k):
     except Exception as e:
         return fail(e)
 
+@app.route('/api/interests/search', methods=['GET'])
+def api_search_interests():
+    if lib is None:
+        return lib_missing()
+    try:
+        # ?all=rust,hiking&any=...&none=golf&k=20
+        k = int(request.args.get('k', 20))
+        s = _api_search_interests_py(request.args.get('all', ''), request.args.get('any', ''),
+                                     request.args.get('none', ''), k)
+        res = try_parse_json(s)
+        if not isinstance(res, dict):
+            return ok({'users': res})
+        return ok({'matches': res.get('matches'), 'users': res.get('users', [])})
+    except Exception as e:
+        return fail(e)
+
+@app.route('/api/changes', methods=['GET'])
+def api_changes():
+    if lib is None:
+        return lib_missing()
+    try:
+        # ?since=<last seq seen>&max=500; on overflow, resync and continue from next
+        since = int(request.args.get('since', 0))
+        max_events = int(request.args.get('max', 500))
+        res = try_parse_json(_api_changes_since_py(since, max_events))
+        if not isinstance(res, dict):
+            return fail('invalid cursor', 400)
+        return ok(res)
+    except Exception as e:
+        return fail(e)
+
 if __name__ == '__main__':
     port = int(os.environ.get('PORT', '5000'))
     print("Starting Flask on port", port)
@@ -0,0 +1,234 @@
+#include "ApiStats.h"
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <sstream>
+#include <algorithm>
+
+namespace {
+
+// Must match the order of enum ApiFn.
+const char *kFnNames[(int)ApiFn::Count] = {
+    "_api_add_user",
+    "_api_add_user_with_id",
+    "_api_add_friend",
+    "_api_remove_friend",
+    "_api_remove_user",
+    "_api_add_interests",
+    "_api_get_user_interests",
+    "_api_list_all_users",
+    "_api_print_user_info",
+    "_api_recommend_mutual",
+    "_api_recommend_weighted",
+    "_api_shortest_path",
+    "_api_connected_components",
+    "_api_suggest_prefix",
+    "_api_save_network",
+    "_api_load_network",
+    "_api_memory_report",
+    "_api_triangle_stats",
+    "_api_local_clustering",
+    "_api_top_clustered",
+    "_api_top_influencers",
+    "_api_top_bridges",
+    "_api_communities",
+    "_api_core_number",
+    "_api_k_core",
+    "_api_recommend_random_walk",
+    "_api_build_distance_index",
+    "_api_distance",
+    "_api_set_worker_count",
+    "_api_thread_pool_info",
+    "_api_submit_job",
+    "_api_job_status",
+    "_api_job_cancel",
+    "_api_job_result",
+    "_api_recommend_batch_begin",
+    "_api_recommend_batch_next",
+    "_api_recommend_batch_end",
+    "_api_recommend_cache_stats",
+    "_api_recommend_cache_capacity",
+    "_api_recommend_scored",
+    "_api_recommend_filtered",
+    "_api_search_interests",
+    "_api_adjacency_compression",
+    "_api_add_friends_bulk",
+    "_api_changes_since",
+    "_api_set_compressed_snapshots",
+};
+
+// Log-linear buckets: values < 32 are exact, above that every power of two
+// is split into 16 sub-buckets. Values above 2^43 ns (~2.4h) are clamped.
+const int kSubBits = 4;
+const int kSubCount = 1 << kSubBits;
+const int kMaxMsb = 42;
+const int kBuckets = (kMaxMsb - kSubBits) * kSubCount + 2 * kSubCount;
+
+int bucketOf(uint64_t v) {
+    if (v < (uint64_t)(2 * kSubCount)) return (int)v;
+    int msb = 63 - __builtin_clzll(v);
+    if (msb > kMaxMsb) return kBuckets - 1;
+    int shift = msb - kSubBits;
+    return shift * kSubCount + (int)(v >> shift);
+}
+
+// Highest value that falls into a bucket (what HdrHistogram reports).
+uint64_t bucketValue(int idx) {
+    if (idx < 2 * kSubCount) return (uint64_t)idx;
+    int shift = idx / kSubCount - 1;
+    uint64_t sub = (uint64_t)(idx % kSubCount + kSubCount);
+    return ((sub + 1) << shift) - 1;
+}
+
+// Only the owning thread writes a shard, so increments are plain
+// load+store pairs; atomics just make concurrent reads well-defined.
+inline void bump(std::atomic<uint64_t> &a, uint64_t d) {
+    a.store(a.load(std::memory_order_relaxed) + d, std::memory_order_relaxed);
+}
+
+struct FnHist {
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> errors{0};
+    std::atomic<uint64_t> sum{0};
+    std::atomic<uint64_t> max{0};
+    std::atomic<uint64_t> buckets[kBuckets];
+    FnHist() { clear(); }
+    void clear() {
+        count.store(0, std::memory_order_relaxed);
+        errors.store(0, std::memory_order_relaxed);
+        sum.store(0, std::memory_order_relaxed);
+        max.store(0, std::memory_order_relaxed);
+        for (auto &b : buckets) b.store(0, std::memory_order_relaxed);
+    }
+};
+
+struct Shard {
+    std::atomic<uint64_t> gen{0};
+    std::atomic<FnHist*> fns[(int)ApiFn::Count];
+    Shard() { for (auto &f : fns) f.store(nullptr, std::memory_order_relaxed); }
+    ~Shard() { for (auto &f : fns) delete f.load(std::memory_order_relaxed); }
+};
+
+// Plain totals used while aggregating.
+struct Totals {
+    uint64_t count = 0, errors = 0, sum = 0, max = 0;
+    std::vector<uint64_t> buckets = std::vector<uint64_t>(kBuckets, 0);
+};
+
+std::atomic<uint64_t> gGeneration{1};
+std::mutex gRegistryMutex;
+std::vector<Shard*> gShards;          // live threads
+Totals gRetired[(int)ApiFn::Count];   // threads that have exited
+
+void addShard(Totals *out, const Shard *s) {
+    for (int f = 0; f < (int)ApiFn::Count; ++f) {
+        const FnHist *h = s->fns[f].load(std::memory_order_acquire);
+        if (!h) continue;
+        Totals &t = out[f];
+        t.count += h->count.load(std::memory_order_relaxed);
+        t.errors += h->errors.load(std::memory_order_relaxed);
+        t.sum += h->sum.load(std::memory_order_relaxed);
+        t.max = std::max(t.max, h->max.load(std::memory_order_relaxed));
+        for (int b = 0; b < kBuckets; ++b)
+            t.buckets[b] += h->buckets[b].load(std::memory_order_relaxed);
+    }
+}
+
+struct ShardHolder {
+    Shard *shard;
+    ShardHolder() : shard(new Shard()) {
+        shard->gen.store(gGeneration.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        std::lock_guard<std::mutex> lock(gRegistryMutex);
+        gShards.push_back(shard);
+    }
+    ~ShardHolder() {
+        std::lock_guard<std::mutex> lock(gRegistryMutex);
+        if (shard->gen.load(std::memory_order_relaxed) == gGeneration.load(std::memory_order_relaxed))
+            addShard(gRetired, shard);
+        gShards.erase(std::remove(gShards.begin(), gShards.end(), shard), gShards.end());
+        delete shard;
+    }
+};
+
+Shard &localShard() {
+    thread_local ShardHolder holder;
+    return *holder.shard;
+}
+
+uint64_t percentile(const Totals &t, double q) {
+    if (t.count == 0) return 0;
+    uint64_t rank = (uint64_t)(q * (double)t.count + 0.5);
+    if (rank < 1) rank = 1;
+    uint64_t seen = 0;
+    for (int b = 0; b < kBuckets; ++b) {
+        seen += t.buckets[b];
+        if (seen >= rank) return std::min(bucketValue(b), t.max);
+    }
+    return t.max;
+}
+
+} // namespace
+
+void ApiStats::record(ApiFn fn, uint64_t nanos, bool failed) {
+    Shard &s = localShard();
+    uint64_t gen = gGeneration.load(std::memory_order_relaxed);
+    if (s.gen.load(std::memory_order_relaxed) != gen) {
+        // A reset happened since this thread last recorded: start over.
+        for (auto &f : s.fns) {
+            FnHist *h = f.load(std::memory_order_relaxed);
+            if (h) h->clear();
+        }
+        s.gen.store(gen, std::memory_order_release);
+    }
+
+    FnHist *h = s.fns[(int)fn].load(std::memory_order_relaxed);
+    if (!h) {
+        h = new FnHist();
+        s.fns[(int)fn].store(h, std::memory_order_release);
+    }
+    bump(h->count, 1);
+    if (failed) bump(h->errors, 1);
+    bump(h->sum, nanos);
+    if (nanos > h->max.load(std::memory_order_relaxed)) h->max.store(nanos, std::memory_order_relaxed);
+    bump(h->buckets[bucketOf(nanos)], 1);
+}
+
+std::string ApiStats::toJson() {
+    Totals totals[(int)ApiFn::Count];
+    {
+        std::lock_guard<std::mutex> lock(gRegistryMutex);
+        uint64_t gen = gGeneration.load(std::memory_order_relaxed);
+        for (int f = 0; f < (int)ApiFn::Count; ++f) totals[f] = gRetired[f];
+        for (const Shard *s : gShards) {
+            if (s->gen.load(std::memory_order_acquire) != gen) continue; // stale since reset
+            addShard(totals, s);
+        }
+    }
+
+    std::ostringstream oss;
+    oss << "{\"calls\":[";
+    for (int f = 0; f < (int)ApiFn::Count; ++f) {
+        const Totals &t = totals[f];
+        if (f) oss << ",";
+        oss << "{";
+        oss << "\"name\":\"" << kFnNames[f] << "\",";
+        oss << "\"count\":" << t.count << ",";
+        oss << "\"errors\":" << t.errors << ",";
+        oss << "\"mean_ns\":" << (t.count ? t.sum / t.count : 0) << ",";
+        oss << "\"p50_ns\":" << percentile(t, 0.50) << ",";
+        oss << "\"p99_ns\":" << percentile(t, 0.99) << ",";
+        oss << "\"p999_ns\":" << percentile(t, 0.999) << ",";
+        oss << "\"max_ns\":" << t.max;
+        oss << "}";
+    }
+    oss << "]}";
+    return oss.str();
+}
+
+void ApiStats::reset() {
+    std::lock_guard<std::mutex> lock(gRegistryMutex);
+    for (auto &t : gRetired) t = Totals();
+    // Live shards notice the new generation on their next record() and
+    // clear themselves; until then toJson() ignores them.
+    gGeneration.fetch_add(1, std::memory_order_relaxed);
+}
@@ -0,0 +1,122 @@
+#ifndef API_STATS_H
+#define API_STATS_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Identifies every exported `_api_*` entry point that is measured.
+ *
+ * Keep this list and the name table in ApiStats.cpp in the same order.
+ */
+enum class ApiFn : int {
+    AddUser = 0,
+    AddUserWithId,
+    AddFriend,
+    RemoveFriend,
+    RemoveUser,
+    AddInterests,
+    GetUserInterests,
+    ListAllUsers,
+    PrintUserInfo,
+    RecommendMutual,
+    RecommendWeighted,
+    ShortestPath,
+    ConnectedComponents,
+    SuggestPrefix,
+    SaveNetwork,
+    LoadNetwork,
+    MemoryReport,
+    TriangleStats,
+    LocalClustering,
+    TopClustered,
+    TopInfluencers,
+    TopBridges,
+    Communities,
+    CoreNumber,
+    KCore,
+    RecommendRandomWalk,
+    BuildDistanceIndex,
+    Distance,
+    SetWorkerCount,
+    ThreadPoolInfo,
+    SubmitJob,
+    JobStatus,
+    JobCancel,
+    JobResult,
+    RecommendBatchBegin,
+    RecommendBatchNext,
+    RecommendBatchEnd,
+    RecommendCacheStats,
+    RecommendCacheCapacity,
+    RecommendScored,
+    RecommendFiltered,
+    SearchInterests,
+    AdjacencyCompression,
+    AddFriendsBulk,
+    ChangesSince,
+    SetCompressedSnapshots,
+    Count
+};
+
+/**
+ * @class ApiStats
+ * @brief Per-function call counters and latency histograms for the C API.
+ *
+ * Each calling thread records into its own shard, so the hot path is a few
+ * uncontended relaxed stores. Latencies go into an HDR-style log-linear
+ * histogram (16 sub-buckets per power of two, ~6% relative error), which
+ * keeps p50/p99/p999 accurate over nanoseconds to minutes.
+ */
+class ApiStats {
+public:
+    /**
+     * @brief Records one finished call.
+     * @param fn The entry point.
+     * @param nanos Wall-clock duration of the call.
+     * @param failed Whether the call reported failure to its caller.
+     */
+    static void record(ApiFn fn, uint64_t nanos, bool failed);
+
+    /**
+     * @brief Aggregates all shards into a JSON document.
+     * @return `{"calls":[{"name":...,"count":...,"errors":...,"p50_ns":...},...]}`
+     */
+    static std::string toJson();
+
+    /**
+     * @brief Discards everything recorded so far.
+     */
+    static void reset();
+};
+
+/**
+ * @brief RAII timer placed at the top of an `_api_*` function.
+ *
+ * Call fail() (or use the pass-through helpers) before returning an error
+ * result so the call is counted in the error column.
+ */
+class ApiCall {
+public:
+    explicit ApiCall(ApiFn fn) : fn(fn), failed(false), start(std::chrono::steady_clock::now()) {}
+
+    ~ApiCall() {
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        ApiStats::record(fn, ns > 0 ? (uint64_t)ns : 0, failed);
+    }
+
+    void fail() { failed = true; }
+
+    // Pass-through helpers: mark the usual failure values of each return type.
+    bool check(bool ok) { if (!ok) failed = true; return ok; }
+    int check(int id) { if (id < 0) failed = true; return id; }
+
+private:
+    ApiFn fn;
+    bool failed;
+    std::chrono::steady_clock::time_point start;
+};
+
+#endif // API_STATS_H
@@ -0,0 +1,79 @@
+#include "ChangeFeed.h"
+#include <algorithm>
+
+ChangeFeed::ChangeFeed() : slots(new Slot[kCapacity]), head(0) {
+    for (size_t i = 0; i < kCapacity; ++i) {
+        slots[i].seq.store(0, std::memory_order_relaxed);
+        slots[i].payload.store(0, std::memory_order_relaxed);
+        slots[i].b.store(0, std::memory_order_relaxed);
+    }
+}
+
+// =============================================================
+// 1️⃣ Writer
+// =============================================================
+uint64_t ChangeFeed::record(ChangeType type, int a, int b) {
+    uint64_t seq = head.load(std::memory_order_relaxed) + 1;
+    Slot &slot = slots[seq % kCapacity];
+
+    // Readers that catch the slot mid-write see sequence 0 and retry or bail
+    slot.seq.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.payload.store(((uint64_t)type << 32) | (uint32_t)a, std::memory_order_relaxed);
+    slot.b.store(b, std::memory_order_relaxed);
+    slot.seq.store(seq, std::memory_order_release);
+    head.store(seq, std::memory_order_release);
+    return seq;
+}
+
+
+// =============================================================
+// 2️⃣ Readers
+// =============================================================
+ChangeBatch ChangeFeed::since(uint64_t cursor, size_t maxEvents) const {
+    ChangeBatch out{{}, cursor, head.load(std::memory_order_acquire), false};
+    uint64_t oldest = out.latest > kCapacity ? out.latest - kCapacity + 1 : 1;
+
+    // A cursor past the head comes from an earlier process; one older than
+    // the ring has missed events. Either way the consumer must resync.
+    if (cursor > out.latest || cursor + 1 < oldest) {
+        out.overflow = true;
+        out.next = out.latest;
+        return out;
+    }
+
+    uint64_t last = std::min(out.latest, cursor + (uint64_t)maxEvents);
+    out.events.reserve((size_t)(last - cursor));
+    for (uint64_t seq = cursor + 1; seq <= last; ++seq) {
+        const Slot &slot = slots[seq % kCapacity];
+        uint64_t before = slot.seq.load(std::memory_order_acquire);
+        uint64_t payload = slot.payload.load(std::memory_order_relaxed);
+        int b = slot.b.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t after = slot.seq.load(std::memory_order_relaxed);
+
+        // The writer lapped us while reading
+        if (before != seq || after != seq) {
+            out.events.clear();
+            out.overflow = true;
+            out.latest = head.load(std::memory_order_acquire);
+            out.next = out.latest;
+            return out;
+        }
+        out.events.push_back(ChangeEvent{seq, (ChangeType)(payload >> 32), (int)(uint32_t)payload, b});
+    }
+    out.next = last;
+    return out;
+}
+
+const char *ChangeFeed::typeName(ChangeType type) {
+    switch (type) {
+        case ChangeType::AddUser: return "add_user";
+        case ChangeType::RemoveUser: return "remove_user";
+        case ChangeType::AddFriend: return "add_friend";
+        case ChangeType::RemoveFriend: return "remove_friend";
+        case ChangeType::Interests: return "interests";
+        case ChangeType::Reset: return "reset";
+    }
+    return "unknown";
+}
@@ -0,0 +1,83 @@
+#ifndef CHANGE_FEED_H
+#define CHANGE_FEED_H
+
+#include <atomic>
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Kind of graph mutation recorded in the ChangeFeed.
+ *
+ * Events name what changed, not the new data: consumers re-read the
+ * affected user (name, interests) when they need it. Reset means the whole
+ * graph was replaced (load), so consumers must resync.
+ */
+enum class ChangeType : uint8_t { AddUser, RemoveUser, AddFriend, RemoveFriend, Interests, Reset };
+
+struct ChangeEvent {
+    uint64_t seq;      ///< 1, 2, 3, ... in mutation order
+    ChangeType type;
+    int a;             ///< User id (first endpoint for friendships)
+    int b;             ///< Second endpoint for friendships, else 0
+};
+
+/**
+ * @brief Result of ChangeFeed::since().
+ */
+struct ChangeBatch {
+    std::vector<ChangeEvent> events;
+    uint64_t next;     ///< Cursor for the following call
+    uint64_t latest;   ///< Sequence number of the newest event
+    bool overflow;     ///< Events after the cursor were overwritten: resync, then continue from next
+};
+
+/**
+ * @class ChangeFeed
+ * @brief Bounded log of graph mutations for incremental consumers.
+ *
+ * Events go into a fixed ring of kCapacity slots, each stamped with a
+ * sequence number. There is one writer (the thread applying mutations) and
+ * any number of readers; neither side takes a lock. A slot is published
+ * seqlock-style: the writer clears its sequence, stores the payload and
+ * then stores the new sequence with release order, and a reader keeps a
+ * copy only if it saw the same expected sequence before and after reading
+ * the payload. Once the writer laps a reader's cursor the overwritten
+ * events are gone and since() reports overflow.
+ */
+class ChangeFeed {
+public:
+    static const size_t kCapacity = 1 << 16;
+
+    ChangeFeed();
+
+    /**
+     * @brief Appends one event (writer thread only).
+     * @return Its sequence number.
+     */
+    uint64_t record(ChangeType type, int a, int b = 0);
+
+    /**
+     * @brief Events with sequence numbers above @p cursor, oldest first.
+     * @param cursor Last sequence number the caller has seen (0 at start).
+     * @param maxEvents At most this many events are returned.
+     */
+    ChangeBatch since(uint64_t cursor, size_t maxEvents) const;
+
+    uint64_t latest() const { return head.load(std::memory_order_acquire); }
+
+    static const char *typeName(ChangeType type);
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> seq;      // 0 while being written
+        std::atomic<uint64_t> payload;  // type << 32 | (uint32_t)a
+        std::atomic<int> b;
+    };
+
+    std::unique_ptr<Slot[]> slots;
+    std::atomic<uint64_t> head;         // last published sequence number
+};
+
+#endif // CHANGE_FEED_H
@@ -0,0 +1,256 @@
+#include "CompressedCsr.h"
+#include "CsrGraph.h"
+#include "CoreGraph.h"
+#include "Parallel.h"
+#include "SetIntersection.h"
+#include <algorithm>
+#include <chrono>
+
+// =============================================================
+// 1️⃣ Encoding
+// =============================================================
+static size_t varintSize(uint32_t v) {
+    size_t n = 1;
+    while (v >= 0x80) {
+        v >>= 7;
+        ++n;
+    }
+    return n;
+}
+
+static uint8_t *writeVarint(uint8_t *p, uint32_t v) {
+    while (v >= 0x80) {
+        *p++ = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    *p++ = (uint8_t)v;
+    return p;
+}
+
+static uint32_t zigzag(int d) {
+    return ((uint32_t)d << 1) ^ (uint32_t)(d >> 31);
+}
+
+// Calls put(value) for the varints of row u with sorted neighbors [nb, end)
+template <class Put>
+static void encodeRow(int u, const int *nb, const int *end, Put &&put) {
+    put((uint32_t)(end - nb));
+    if (nb == end) return;
+    put(zigzag(*nb - u));
+    for (const int *p = nb + 1; p != end; ++p) put((uint32_t)(*p - p[-1] - 1));
+}
+
+// rowOf(u, scratch, encode) calls encode(begin, end) with u's sorted
+// neighbor indices, using scratch (one per worker) if it needs a buffer
+template <class RowOf>
+std::shared_ptr<CompressedCsr> CompressedCsr::encode(int n, RowOf &&rowOf) {
+    std::shared_ptr<CompressedCsr> c(new CompressedCsr());
+    c->offsets.assign((size_t)n + 1, 0);
+    ParallelScope scope;
+    std::vector<std::vector<int>> scratch(scope.workers());
+
+    // Step 1: Row sizes, then offsets
+    parallelFor(0, (size_t)n, 4096, [&](size_t lo, size_t hi, unsigned worker) {
+        for (size_t u = lo; u < hi; ++u) {
+            size_t size = 0;
+            rowOf((int)u, scratch[worker], [&](const int *nb, const int *end) {
+                encodeRow((int)u, nb, end, [&](uint32_t v) { size += varintSize(v); });
+            });
+            c->offsets[u + 1] = size;
+        }
+    });
+    for (int u = 0; u < n; ++u) c->offsets[u + 1] += c->offsets[u];
+
+    // Step 2: Encode every row into its slot
+    c->bytes.resize(c->offsets[n]);
+    parallelFor(0, (size_t)n, 4096, [&](size_t lo, size_t hi, unsigned worker) {
+        for (size_t u = lo; u < hi; ++u) {
+            uint8_t *p = c->bytes.data() + c->offsets[u];
+            rowOf((int)u, scratch[worker], [&](const int *nb, const int *end) {
+                encodeRow((int)u, nb, end, [&](uint32_t v) { p = writeVarint(p, v); });
+            });
+        }
+    });
+    return c;
+}
+
+std::shared_ptr<const CompressedCsr> CompressedCsr::build(const CsrGraph &g) {
+    auto c = encode(g.numNodes(), [&](int u, std::vector<int> &, auto &&row) { row(g.begin(u), g.end(u)); });
+    c->ids.resize(g.numNodes());
+    for (int u = 0; u < g.numNodes(); ++u) c->ids[u] = g.idOf(u);
+    c->ver = g.version();
+    return c;
+}
+
+std::shared_ptr<const CompressedCsr> CompressedCsr::build(const CoreGraph &graph) {
+    std::vector<int> ids = graph.listAllUsers();
+    auto indexIn = [&](int id) { return (int)(std::lower_bound(ids.begin(), ids.end(), id) - ids.begin()); };
+    auto c = encode((int)ids.size(), [&](int u, std::vector<int> &buf, auto &&row) {
+        buf.clear();
+        graph.neighbors(ids[u]).appendSorted(buf);
+        // ids are ascending, so sorted ids map to sorted indices
+        for (int &v : buf) v = indexIn(v);
+        row(buf.data(), buf.data() + buf.size());
+    });
+    c->ids = std::move(ids);
+    c->ver = graph.version();
+    return c;
+}
+
+
+// =============================================================
+// 2️⃣ Queries
+// =============================================================
+int CompressedCsr::indexOf(int id) const {
+    auto it = std::lower_bound(ids.begin(), ids.end(), id);
+    if (it == ids.end() || *it != id) return -1;
+    return (int)(it - ids.begin());
+}
+
+uint32_t CompressedCsr::degree(int u) const {
+    const uint8_t *p = bytes.data() + offsets[u];
+    return readVarint(p);
+}
+
+size_t CompressedCsr::decode(int u, int *out) const {
+    size_t n = 0;
+    forEachNeighbor(u, [&](int v) { out[n++] = v; });
+    return n;
+}
+
+bool CompressedCsr::hasEdge(int u, int v) const {
+    const uint8_t *p = bytes.data() + offsets[u];
+    uint32_t deg = readVarint(p);
+    if (deg == 0) return false;
+    uint32_t z = readVarint(p);
+    int w = u + (int)((z >> 1) ^ (0u - (z & 1)));
+    for (uint32_t i = 1; w < v && i < deg; ++i) w += (int)readVarint(p) + 1;
+    return w == v;
+}
+
+size_t CompressedCsr::intersectCount(int u, int v) const {
+    // Two decoding cursors advanced merge-style
+    struct Cursor {
+        const uint8_t *p;
+        uint32_t left;
+        int value;
+        bool next() {
+            if (left == 0) return false;
+            --left;
+            value += (int)readVarint(p) + 1;
+            return true;
+        }
+    };
+    auto open = [&](int x, Cursor &c) {
+        c.p = bytes.data() + offsets[x];
+        c.left = readVarint(c.p);
+        if (c.left == 0) return false;
+        --c.left;
+        uint32_t z = readVarint(c.p);
+        c.value = x + (int)((z >> 1) ^ (0u - (z & 1)));
+        return true;
+    };
+
+    Cursor a, b;
+    if (!open(u, a) || !open(v, b)) return 0;
+    size_t common = 0;
+    while (true) {
+        if (a.value < b.value) {
+            if (!a.next()) break;
+        } else if (b.value < a.value) {
+            if (!b.next()) break;
+        } else {
+            ++common;
+            if (!a.next() || !b.next()) break;
+        }
+    }
+    return common;
+}
+
+size_t CompressedCsr::memoryBytes() const {
+    return ids.capacity() * sizeof(int) + offsets.capacity() * sizeof(size_t) + bytes.capacity();
+}
+
+
+// =============================================================
+// 3️⃣ Memory vs Traversal Comparison
+// =============================================================
+namespace {
+using Clock = std::chrono::steady_clock;
+
+double msSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// Sum of BFS distances from src; forEach(u, fn) enumerates neighbors
+template <class ForEach>
+uint64_t bfsDistanceSum(int n, int src, ForEach &&forEach) {
+    std::vector<int> dist(n, -1);
+    std::vector<int> frontier;
+    frontier.reserve(n);
+    dist[src] = 0;
+    frontier.push_back(src);
+    uint64_t sum = 0;
+    for (size_t head = 0; head < frontier.size(); ++head) {
+        int u = frontier[head];
+        sum += (uint64_t)dist[u];
+        forEach(u, [&](int v) {
+            if (dist[v] < 0) {
+                dist[v] = dist[u] + 1;
+                frontier.push_back(v);
+            }
+        });
+    }
+    return sum;
+}
+}
+
+CompressionReport CompressedCsr::compare(const CsrGraph &g, int bfsSources) {
+    CompressionReport r{};
+    int n = g.numNodes();
+    r.nodes = n;
+    r.edges = g.numEdges();
+    r.csrBytes = (size_t)n * sizeof(int) + ((size_t)n + 1) * sizeof(size_t) + r.edges * 2 * sizeof(int);
+
+    Clock::time_point t = Clock::now();
+    auto c = build(g);
+    r.buildMs = msSince(t);
+    r.compressedBytes = c->memoryBytes();
+    r.bitsPerEdge = r.edges ? 8.0 * (double)c->bytes.size() / (double)(r.edges * 2) : 0.0;
+    r.consistent = true;
+    if (n == 0) return r;
+
+    // BFS from evenly spread sources
+    if (bfsSources < 1) bfsSources = 1;
+    uint64_t plainSum = 0, packedSum = 0;
+    t = Clock::now();
+    for (int s = 0; s < bfsSources; ++s) {
+        plainSum += bfsDistanceSum(n, (int)((int64_t)s * n / bfsSources), [&](int u, auto &&visit) {
+            for (const int *p = g.begin(u); p != g.end(u); ++p) visit(*p);
+        });
+    }
+    r.csrBfsMs = msSince(t);
+    t = Clock::now();
+    for (int s = 0; s < bfsSources; ++s) {
+        packedSum += bfsDistanceSum(n, (int)((int64_t)s * n / bfsSources), [&](int u, auto &&visit) {
+            c->forEachNeighbor(u, visit);
+        });
+    }
+    r.compressedBfsMs = msSince(t);
+
+    // Mutual-neighbor counts over the edges of up to 4096 spread rows
+    int stride = n > 4096 ? n / 4096 : 1;
+    uint64_t plainCommon = 0, packedCommon = 0;
+    t = Clock::now();
+    for (int u = 0; u < n; u += stride)
+        for (const int *p = g.begin(u); p != g.end(u); ++p)
+            plainCommon += intersectSortedCount(g.begin(u), g.degree(u), g.begin(*p), g.degree(*p));
+    r.csrIntersectMs = msSince(t);
+    t = Clock::now();
+    for (int u = 0; u < n; u += stride)
+        c->forEachNeighbor(u, [&](int v) { packedCommon += c->intersectCount(u, v); });
+    r.compressedIntersectMs = msSince(t);
+
+    r.consistent = plainSum == packedSum && plainCommon == packedCommon;
+    return r;
+}
@@ -0,0 +1,124 @@
+#ifndef COMPRESSED_CSR_H
+#define COMPRESSED_CSR_H
+
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+
+class CsrGraph;
+class CoreGraph;
+
+/**
+ * @brief Memory and traversal cost of CsrGraph vs CompressedCsr, measured
+ * on the same snapshot (see CompressedCsr::compare).
+ */
+struct CompressionReport {
+    int nodes;
+    size_t edges;
+    size_t csrBytes;
+    size_t compressedBytes;
+    double bitsPerEdge;        ///< Compressed neighbor bits per directed edge
+    double buildMs;            ///< Time to encode the snapshot
+    double csrBfsMs;           ///< Full BFS from each sampled source
+    double compressedBfsMs;
+    double csrIntersectMs;     ///< Mutual-neighbor counts over sampled edges
+    double compressedIntersectMs;
+    bool consistent;           ///< Both representations gave the same answers
+};
+
+/**
+ * @class CompressedCsr
+ * @brief Read-only adjacency of a CsrGraph with neighbor lists stored as
+ * delta-encoded varints.
+ *
+ * Each row is its degree followed by the zigzag-encoded distance of the
+ * first neighbor from the row's own index, then the gaps between
+ * consecutive neighbors minus one, all as LEB128 varints. Dense indices
+ * follow id order, so clustered ids give small gaps and most neighbors
+ * take one byte instead of four. Rows are decoded on the fly while
+ * iterating, so traversals never materialize the full list.
+ *
+ * This is an optional representation for very large graphs: it trades
+ * decode work per visited edge for memory. With
+ * CoreGraph::setCompressedSnapshots() it replaces the plain CSR as the
+ * cached snapshot; compare() measures both sides on the current snapshot.
+ * Dense indices, idOf() and indexOf() match the CsrGraph of the same
+ * graph version.
+ */
+class CompressedCsr {
+public:
+    /**
+     * @brief Encodes a snapshot; rows are encoded in parallel.
+     */
+    static std::shared_ptr<const CompressedCsr> build(const CsrGraph &g);
+
+    /**
+     * @brief Encodes the live graph directly, without an intermediate
+     * plain CSR. Like CsrGraph::build(), must not overlap writers.
+     */
+    static std::shared_ptr<const CompressedCsr> build(const CoreGraph &graph);
+
+    uint64_t version() const { return ver; }          ///< CoreGraph::version() at build time
+    int numNodes() const { return (int)(offsets.size() - 1); }
+    int idOf(int u) const { return ids[u]; }
+    int indexOf(int id) const;                        ///< Dense index of a user id, or -1
+    uint32_t degree(int u) const;
+
+    /**
+     * @brief Calls fn(v) for every neighbor v of u in ascending order.
+     */
+    template <class Fn>
+    void forEachNeighbor(int u, Fn &&fn) const {
+        const uint8_t *p = bytes.data() + offsets[u];
+        uint32_t deg = readVarint(p);
+        if (deg == 0) return;
+        uint32_t z = readVarint(p);
+        int v = u + (int)((z >> 1) ^ (0u - (z & 1)));
+        fn(v);
+        for (uint32_t i = 1; i < deg; ++i) {
+            v += (int)readVarint(p) + 1;
+            fn(v);
+        }
+    }
+
+    /**
+     * @brief Decodes u's neighbors into @p out (room for degree(u) ints).
+     */
+    size_t decode(int u, int *out) const;
+
+    bool hasEdge(int u, int v) const;                 ///< Scans u's row until v
+    size_t intersectCount(int u, int v) const;        ///< |N(u) ∩ N(v)| by merging two streams
+
+    size_t memoryBytes() const;
+
+    /**
+     * @brief Builds the compressed form of @p g and times BFS and
+     * intersection on both representations.
+     * @param bfsSources Number of BFS sources (spread over the nodes).
+     */
+    static CompressionReport compare(const CsrGraph &g, int bfsSources = 4);
+
+private:
+    CompressedCsr() : ver(0) {}
+
+    template <class RowOf>
+    static std::shared_ptr<CompressedCsr> encode(int n, RowOf &&rowOf);
+
+    static uint32_t readVarint(const uint8_t *&p) {
+        uint32_t v = *p & 0x7f;
+        int shift = 7;
+        while (*p++ & 0x80) {
+            v |= (uint32_t)(*p & 0x7f) << shift;
+            shift += 7;
+        }
+        return v;
+    }
+
+    std::vector<int> ids;         // dense index -> user id (ascending)
+    std::vector<size_t> offsets;  // n + 1 byte offsets into bytes
+    std::vector<uint8_t> bytes;   // encoded rows
+    uint64_t ver;
+};
+
+#endif // COMPRESSED_CSR_H
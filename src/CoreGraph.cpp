@@ -1,37 +1,61 @@
 #include "CoreGraph.h"
+#include "MemoryReport.h"
+#include "SetIntersection.h"
+#include "CsrGraph.h"
+#include "CompressedCsr.h"
+#include "GraphVersion.h"
+#include "Parallel.h"
 #include <algorithm>
 #include <iostream>
+#include <iterator>
 
-CoreGraph::CoreGraph() : nextId(1) {}
+CoreGraph::CoreGraph() : nextId(1), ver(0), clock(0), removedSlots(0), compressedSnaps(false),
+      orderDirty(false), republishAll(true) {}
+
+CoreGraph::~CoreGraph() {
+    clear();
+}
 
 int CoreGraph::addUser(const std::string &name) {
     int id = nextId++;
-    users[id] = User{id, name};
-    if (adj.find(id) == adj.end()) adj[id] = {};
+    addUser(name, id);
     return id;
 }
 
 bool CoreGraph::addUser(const std::string &name, int fixedId) {
     if (fixedId <= 0) return false;
-    if (users.find(fixedId) != users.end()) return false; // already present
-    users[fixedId] = User{fixedId, name};
-    if (adj.find(fixedId) == adj.end()) adj[fixedId] = {};
+    if (denseIndex(fixedId) >= 0) return false; // already present
+    mapId(fixedId, (int)users.size());
+    users.push_back(User{fixedId, nameArena.add(name), {}});
+    adj.emplace_back();
+    stamps.push_back(++clock);
+    dirtyMark.push_back(0);
+    markDirty((int)users.size() - 1);
+    orderDirty = true;
+    // Ids usually arrive in ascending order
+    if (sortedIds.empty() || sortedIds.back() < fixedId) sortedIds.push_back(fixedId);
+    else sortedIds.insert(std::lower_bound(sortedIds.begin(), sortedIds.end(), fixedId), fixedId);
+    interestIdx.addUser(fixedId);
     if (fixedId >= nextId) nextId = fixedId + 1;
+    ++ver;
     return true;
 }
 
 bool CoreGraph::addInterest(int id, const std::string &interest) {
-    auto it = users.find(id);
-    if (it == users.end()) return false;
+    int u = denseIndex(id);
+    if (u < 0) return false;
     std::string lower = interest;
     std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
-    it->second.interests.insert(lower);
+    if (users[u].interests.insert(lower).second) {
+        interestIdx.add(lower, id);
+        touch(id);
+        for (int f : adj[u]) touch(f);
+    }
     return true;
 }
 
 bool CoreGraph::addInterests(int id, const std::vector<std::string> &interests) {
-    auto it = users.find(id);
-    if (it == users.end()) return false;
+    if (denseIndex(id) < 0) return false;
 
     for (const auto &i : interests) {
         addInterest(id, i);
@@ -39,73 +63,421 @@ bool CoreGraph::addInterests(int id, const std::vector<std::string> &interests)
     return true;
 }
 
+std::vector<int> CoreGraph::searchInterests(const InterestQuery &query, int topK, size_t *matches) const {
+    auto lowered = [](std::vector<std::string> terms) {
+        for (auto &t : terms) std::transform(t.begin(), t.end(), t.begin(), ::tolower);
+        return terms;
+    };
+    RoaringBitmap hits = interestIdx.search({lowered(query.all), lowered(query.any), lowered(query.none)});
+    if (matches) *matches = hits.cardinality();
+    if (topK <= 0) return {};
+
+    // Bounded heap whose root is the weakest of the current top-K
+    std::vector<std::pair<size_t,int>> heap;
+    auto better = [](const std::pair<size_t,int> &a, const std::pair<size_t,int> &b) {
+        if (a.first != b.first) return a.first > b.first;
+        return a.second < b.second;
+    };
+    hits.forEach([&](uint32_t id) {
+        std::pair<size_t,int> e{degree((int)id), (int)id};
+        if ((int)heap.size() < topK) {
+            heap.push_back(e);
+            std::push_heap(heap.begin(), heap.end(), better);
+        } else if (better(e, heap.front())) {
+            std::pop_heap(heap.begin(), heap.end(), better);
+            heap.back() = e;
+            std::push_heap(heap.begin(), heap.end(), better);
+        }
+    });
+    std::sort_heap(heap.begin(), heap.end(), better);
+    std::vector<int> out;
+    for (auto &e : heap) out.push_back(e.second);
+    return out;
+}
+
 bool CoreGraph::removeUser(int id) {
-    if (users.find(id) == users.end()) return false;
+    int u = denseIndex(id);
+    if (u < 0) return false;
+    interestIdx.removeUser(id, users[u].interests);
     // remove id from neighbors
-    if (adj.find(id) != adj.end()) {
-        for (int v : adj[id]) {
-            adj[v].erase(id);
-        }
-        adj.erase(id);
+    for (int v : adj[u]) {
+        int k = denseIndex(v);
+        if (k >= 0) adj[k].erase(id, pool);
+        touch(v);
     }
-    users.erase(id);
+    adj[u].release(pool);
+
+    // Leave a tombstone; compact once they make up a quarter of the slots
+    markDirty(u);
+    orderDirty = true;
+    nameArena.release(users[u].name);
+    users[u] = User{0, std::string_view(), {}};
+    stamps[u] = 0;
+    unmapId(id);
+    sortedIds.erase(std::lower_bound(sortedIds.begin(), sortedIds.end(), id));
+    ++removedSlots;
+    if (removedSlots >= 64 && removedSlots * 4 >= users.size()) compact();
+    ++ver;
     return true;
 }
 
 bool CoreGraph::userExists(int id) const {
-    return users.find(id) != users.end();
+    return denseIndex(id) >= 0;
 }
 
 const User* CoreGraph::getUser(int id) const {
-    auto it = users.find(id);
-    if (it == users.end()) return nullptr;
-    return &it->second;
+    int u = denseIndex(id);
+    return u < 0 ? nullptr : &users[u];
+}
+
+int CoreGraph::denseIndex(int id) const {
+    if (id > 0 && (size_t)id < directIndex.size()) return directIndex[id];
+    if (sparseIndex.empty()) return -1;
+    auto it = sparseIndex.find(id);
+    return it == sparseIndex.end() ? -1 : it->second;
+}
+
+void CoreGraph::mapId(int id, int index) {
+    if ((size_t)id >= directIndex.size()) {
+        // Grow the direct table only while it stays within a few entries per user
+        size_t limit = 4 * users.size() + 4096;
+        if ((size_t)id >= limit) {
+            sparseIndex[id] = index;
+            return;
+        }
+        size_t size = std::min(std::max((size_t)id + 1, directIndex.size() * 2), limit);
+        directIndex.resize(size, -1);
+        for (auto it = sparseIndex.begin(); it != sparseIndex.end();) {
+            if ((size_t)it->first < size) {
+                directIndex[it->first] = it->second;
+                it = sparseIndex.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+    directIndex[id] = index;
+}
+
+void CoreGraph::unmapId(int id) {
+    if (id > 0 && (size_t)id < directIndex.size()) directIndex[id] = -1;
+    else sparseIndex.erase(id);
+}
+
+void CoreGraph::compact() {
+    size_t live = 0;
+    for (size_t i = 0; i < users.size(); ++i) {
+        if (users[i].id == 0) continue;
+        if (live != i) {
+            users[live] = std::move(users[i]);
+            adj[live] = adj[i];
+            stamps[live] = stamps[i];
+            mapId(users[live].id, (int)live);
+        }
+        ++live;
+    }
+    users.resize(live);
+    adj.resize(live);
+    stamps.resize(live);
+    removedSlots = 0;
+    dirtySlots.clear();
+    dirtyMark.assign(live, 0);
+    republishAll = true;
+
+    // Names of removed users are dead arena bytes; copy the live ones out
+    // once they are outnumbered
+    if (nameArena.wantsCompaction()) {
+        NameArena fresh;
+        for (auto &user : users) user.name = fresh.add(user.name);
+        nameArena.adopt(std::move(fresh));
+    }
 }
 
 bool CoreGraph::addFriend(int a, int b) {
     if (a == b) return false;
-    if (!userExists(a) || !userExists(b)) return false;
-    bool insertedA = adj[a].insert(b).second;
-    bool insertedB = adj[b].insert(a).second;
-    // ensure map entries exist even if no insertion done
-    if (adj.find(a) == adj.end()) adj[a] = {};
-    if (adj.find(b) == adj.end()) adj[b] = {};
+    int ia = denseIndex(a), ib = denseIndex(b);
+    if (ia < 0 || ib < 0) return false;
+    bool insertedA = adj[ia].insert(b, pool);
+    bool insertedB = adj[ib].insert(a, pool);
+    if (insertedA || insertedB) {
+        ++ver;
+        touch(a);
+        touch(b);
+    }
     return insertedA || insertedB;
 }
 
 bool CoreGraph::removeFriend(int a, int b) {
-    if (!userExists(a) || !userExists(b)) return false;
-    size_t ra = 0, rb = 0;
-    if (adj.find(a) != adj.end()) ra = adj[a].erase(b);
-    if (adj.find(b) != adj.end()) rb = adj[b].erase(a);
-    return (ra > 0 || rb > 0);
+    int ia = denseIndex(a), ib = denseIndex(b);
+    if (ia < 0 || ib < 0) return false;
+    bool ra = adj[ia].erase(b, pool);
+    bool rb = adj[ib].erase(a, pool);
+    if (ra || rb) {
+        ++ver;
+        touch(a);
+        touch(b);
+    }
+    return ra || rb;
+}
+
+std::vector<std::pair<int,int>> CoreGraph::addFriendsBulk(const std::vector<std::pair<int,int>> &edges) {
+    // Step 1: Both directions of every valid pair as (user << 32 | friend);
+    // invalid pairs become UINT64_MAX and sort to the end
+    std::vector<uint64_t> keys(edges.size() * 2);
+    parallelFor(0, edges.size(), 4096, [&](size_t lo, size_t hi, unsigned) {
+        for (size_t i = lo; i < hi; ++i) {
+            int a = edges[i].first, b = edges[i].second;
+            bool ok = a != b && userExists(a) && userExists(b);
+            keys[2 * i] = ok ? ((uint64_t)(uint32_t)a << 32) | (uint32_t)b : UINT64_MAX;
+            keys[2 * i + 1] = ok ? ((uint64_t)(uint32_t)b << 32) | (uint32_t)a : UINT64_MAX;
+        }
+    });
+
+    // Step 2: Sort and drop duplicates
+    parallelSort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    if (!keys.empty() && keys.back() == UINT64_MAX) keys.pop_back();
+
+    // Step 3: Rebuild each touched user's list, merged with its current
+    // friends. Each new friendship is seen from both ends; it is reported
+    // from the lower id.
+    std::vector<std::pair<int,int>> inserted;
+    std::vector<int> fresh, current, merged, added;
+    for (size_t i = 0; i < keys.size();) {
+        int u = (int)(keys[i] >> 32);
+        fresh.clear();
+        for (; i < keys.size() && (int)(keys[i] >> 32) == u; ++i) fresh.push_back((int)(uint32_t)keys[i]);
+
+        NeighborList &list = adj[denseIndex(u)];
+        if (list.size() == 0) {
+            list.assign(fresh.data(), (uint32_t)fresh.size(), pool);
+            added.swap(fresh);
+        } else {
+            current.clear();
+            list.appendSorted(current);
+            added.clear();
+            std::set_difference(fresh.begin(), fresh.end(), current.begin(), current.end(), std::back_inserter(added));
+            if (added.empty()) continue;
+            merged.clear();
+            std::set_union(current.begin(), current.end(), added.begin(), added.end(), std::back_inserter(merged));
+            list.assign(merged.data(), (uint32_t)merged.size(), pool);
+        }
+        for (int v : added)
+            if (u < v) inserted.push_back({u, v});
+        touch(u);
+    }
+
+    ver += inserted.size();
+    return inserted;
 }
 
 std::vector<int> CoreGraph::getFriends(int id) const {
     std::vector<int> res;
-    auto it = adj.find(id);
-    if (it == adj.end()) return res;
-    res.insert(res.end(), it->second.begin(), it->second.end());
-    std::sort(res.begin(), res.end());
+    int u = denseIndex(id);
+    if (u < 0) return res;
+    res.reserve(adj[u].size());
+    adj[u].appendSorted(res);
     return res;
 }
 
-std::vector<int> CoreGraph::listAllUsers() const {
-    std::vector<int> res;
-    res.reserve(users.size());
-    for (auto &p : users) res.push_back(p.first);
-    std::sort(res.begin(), res.end());
+const NeighborList &CoreGraph::neighbors(int id) const {
+    static const NeighborList none;
+    int u = denseIndex(id);
+    return u < 0 ? none : adj[u];
+}
+
+size_t CoreGraph::degree(int id) const {
+    int u = denseIndex(id);
+    return u < 0 ? 0 : adj[u].size();
+}
+
+bool CoreGraph::areFriends(int a, int b) const {
+    int u = denseIndex(a);
+    return u >= 0 && adj[u].contains(b);
+}
+
+// Two sorted arrays go through the merge/gallop/SIMD kernel; once a hub
+// (hash set) is involved, walk the smaller side and probe the larger.
+size_t CoreGraph::mutualCount(int a, int b) const {
+    const NeighborList &na = neighbors(a);
+    const NeighborList &nb = neighbors(b);
+    if (na.isSorted() && nb.isSorted())
+        return intersectSortedCount(na.sortedData(), na.size(), nb.sortedData(), nb.size());
+
+    const NeighborList &small = na.size() <= nb.size() ? na : nb;
+    const NeighborList &large = na.size() <= nb.size() ? nb : na;
+    size_t n = 0;
+    for (int v : small) n += large.contains(v);
+    return n;
+}
+
+std::vector<int> CoreGraph::mutualFriends(int a, int b) const {
+    const NeighborList &na = neighbors(a);
+    const NeighborList &nb = neighbors(b);
+    std::vector<int> res(std::min(na.size(), nb.size()));
+    if (na.isSorted() && nb.isSorted()) {
+        res.resize(intersectSorted(na.sortedData(), na.size(), nb.sortedData(), nb.size(), res.data()));
+        return res;
+    }
+
+    const NeighborList &small = na.size() <= nb.size() ? na : nb;
+    const NeighborList &large = na.size() <= nb.size() ? nb : na;
+    size_t n = 0;
+    for (int v : small)
+        if (large.contains(v)) res[n++] = v;
+    res.resize(n);
+    if (!small.isSorted()) std::sort(res.begin(), res.end());
     return res;
 }
 
+std::vector<int> CoreGraph::listAllUsers() const {
+    return sortedIds;
+}
+
 std::unordered_map<int, std::unordered_set<int>> CoreGraph::getAdjacency() const {
-    return adj; // copy
+    std::unordered_map<int, std::unordered_set<int>> res; // copy
+    res.reserve(sortedIds.size());
+    for (size_t u = 0; u < users.size(); ++u) {
+        if (users[u].id == 0) continue;
+        res[users[u].id].insert(adj[u].begin(), adj[u].end());
+    }
+    return res;
 }
 
 void CoreGraph::clear() {
+    for (auto &list : adj) list.release(pool);
     users.clear();
     adj.clear();
+    stamps.clear();
+    dirtySlots.clear();
+    dirtyMark.clear();
+    republishAll = true;
+    nameArena.clear();
+    directIndex.clear();
+    sparseIndex.clear();
+    sortedIds.clear();
+    removedSlots = 0;
+    pool.clear();
+    interestIdx.clear();
     nextId = 1;
+    ++ver;
+}
+
+void CoreGraph::touch(int id) {
+    int u = denseIndex(id);
+    if (u < 0) return;
+    stamps[u] = ++clock;
+    markDirty(u);
+}
+
+void CoreGraph::markDirty(int index) {
+    if (republishAll || dirtyMark[index]) return; // the next pin() rebuilds everything anyway
+    dirtyMark[index] = 1;
+    dirtySlots.push_back(index);
+}
+
+uint64_t CoreGraph::userModified(int id) const {
+    int u = denseIndex(id);
+    return u < 0 ? UINT64_MAX : stamps[u];
+}
+
+std::shared_ptr<const CsrGraph> CoreGraph::snapshot() const {
+    std::lock_guard<std::mutex> lock(snapMutex);
+    if (!compressedSnaps) {
+        if (!snap || snap->version() != ver) snap = CsrGraph::build(*this);
+        return snap;
+    }
+    auto plain = looseSnap.lock();
+    if (!plain || plain->version() != ver) {
+        plain = CsrGraph::build(*this);
+        looseSnap = plain;
+    }
+    return plain;
+}
+
+std::shared_ptr<const CompressedCsr> CoreGraph::compressedSnapshot() const {
+    std::lock_guard<std::mutex> lock(snapMutex);
+    if (!compressedSnaps) return CompressedCsr::build(*this);
+    if (!packedSnap || packedSnap->version() != ver) packedSnap = CompressedCsr::build(*this);
+    return packedSnap;
+}
+
+void CoreGraph::setCompressedSnapshots(bool on) {
+    std::lock_guard<std::mutex> lock(snapMutex);
+    if (on == compressedSnaps) return;
+    compressedSnaps = on;
+    if (on) {
+        looseSnap = snap;
+        snap.reset();
+    } else {
+        packedSnap.reset();
+    }
+}
+
+std::shared_ptr<const GraphVersion> CoreGraph::pin() const {
+    std::lock_guard<std::mutex> lock(versionMutex);
+    if (published && !republishAll && !orderDirty && dirtySlots.empty()) return published;
+
+    using Row = GraphVersion::Row;
+    using Page = GraphVersion::Page;
+    const size_t kPageRows = GraphVersion::kPageRows;
+    auto makeRow = [&](size_t index) -> std::shared_ptr<const Row> {
+        if (index >= users.size() || users[index].id == 0) return nullptr;
+        const User &user = users[index];
+        auto row = std::make_shared<Row>();
+        row->id = user.id;
+        row->name.assign(user.name);
+        row->interests.assign(user.interests.begin(), user.interests.end());
+        row->friends.reserve(adj[index].size());
+        adj[index].appendSorted(row->friends);
+        return row;
+    };
+
+    std::shared_ptr<GraphVersion> next(new GraphVersion());
+    next->ver = ver;
+    next->clock = clock;
+    size_t pageCount = (users.size() + kPageRows - 1) / kPageRows;
+    if (!published || republishAll) {
+        // Step 1a: Every page from scratch
+        next->pages.resize(pageCount);
+        parallelFor(0, pageCount, 1, [&](size_t lo, size_t hi, unsigned) {
+            for (size_t p = lo; p < hi; ++p) {
+                auto page = std::make_shared<Page>(kPageRows);
+                for (size_t i = 0; i < kPageRows; ++i) (*page)[i] = makeRow(p * kPageRows + i);
+                next->pages[p] = page;
+            }
+        });
+    } else {
+        // Step 1b: Share the previous pages; copy those holding changed users
+        next->pages = published->pages;
+        next->pages.resize(pageCount);
+        std::vector<std::shared_ptr<Page>> copied(pageCount);
+        for (int index : dirtySlots) {
+            size_t p = (size_t)index / kPageRows;
+            if (!copied[p]) {
+                copied[p] = next->pages[p] ? std::make_shared<Page>(*next->pages[p]) : std::make_shared<Page>(kPageRows);
+                next->pages[p] = copied[p];
+            }
+            (*copied[p])[(size_t)index % kPageRows] = makeRow((size_t)index);
+        }
+    }
+
+    // Step 2: Id order, rebuilt only when users came or went
+    if (!published || republishAll || orderDirty) {
+        auto order = std::make_shared<std::vector<uint32_t>>();
+        order->reserve(sortedIds.size());
+        for (int id : sortedIds) order->push_back((uint32_t)denseIndex(id));
+        next->order = order;
+    } else {
+        next->order = published->order;
+    }
+
+    for (int index : dirtySlots) dirtyMark[index] = 0;
+    dirtySlots.clear();
+    orderDirty = false;
+    republishAll = false;
+    published = next;
+    return published;
 }
 
 void CoreGraph::printUser(int id) const {
@@ -135,4 +507,41 @@ void CoreGraph::printInterests(int id) const {
     for (const auto &i : u->interests)
         std::cout << i << " ";
     std::cout << "\n";
+}
+
+void CoreGraph::reportMemory(MemoryReport &report) const {
+    // users: profile table + hot stamps; names are reported by the arena
+    size_t interestBytes = 0, interestCount = 0;
+    for (auto &user : users) {
+        const auto &in = user.interests;
+        interestBytes += MemoryReport::tableBytes(in);
+        for (auto &i : in) interestBytes += MemoryReport::stringBytes(i);
+        interestCount += in.size();
+    }
+    report.add("graph.users", users.capacity() * sizeof(User) + stamps.capacity() * sizeof(uint64_t),
+               sortedIds.size());
+    report.add("graph.names", nameArena.memoryBytes(), nameArena.size());
+    size_t indexBytes = (directIndex.capacity() + sortedIds.capacity()) * sizeof(int) +
+                        MemoryReport::tableBytes(sparseIndex);
+    report.add("graph.id_index", indexBytes, directIndex.size() + sparseIndex.size());
+    report.add("graph.interests", interestBytes, interestCount);
+    {
+        std::lock_guard<std::mutex> lock(versionMutex);
+        if (published) report.add("graph.versions", published->memoryBytes(), published->size());
+    }
+    interestIdx.reportMemory(report);
+    {
+        std::lock_guard<std::mutex> lock(snapMutex);
+        if (packedSnap) report.add("graph.compressed_snapshot", packedSnap->memoryBytes(), packedSnap->numNodes());
+    }
+
+    // adjacency: per-user table + pooled neighbor blocks
+    size_t entries = 0;
+    for (auto &list : adj) entries += list.size();
+    report.add("graph.adjacency", adj.capacity() * sizeof(NeighborList) + pool.reservedBytes(), entries);
+    size_t idle = pool.reservedBytes() - pool.usedBytes();
+    if (pool.reservedBytes() > (1u << 20) && idle * 2 > pool.reservedBytes()) {
+        report.warn("graph.adjacency: " + std::to_string(idle) + " of " +
+                    std::to_string(pool.reservedBytes()) + " pooled bytes sit in free blocks");
+    }
 }
\ No newline at end of file
@@ -7,11 +7,24 @@
 #include <unordered_set>
 #include <algorithm>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <cstdint>
+#include "NeighborList.h"
+#include "InterestIndex.h"
+#include "NameArena.h"
 
+class MemoryReport;
+class CsrGraph;
+class CompressedCsr;
+class GraphVersion;
+
+// Cold profile data. Traversals only touch the adjacency and stamp vectors
+// in CoreGraph, so names and interest sets stay out of their cache lines.
 struct User
 {
     int id;
-    std::string name;
+    std::string_view name;                     // interned in CoreGraph::names()
     std::unordered_set<std::string> interests; // user interests
 };
 
@@ -19,6 +32,9 @@ class CoreGraph
 {
 public:
     CoreGraph();
+    ~CoreGraph();
+    CoreGraph(const CoreGraph &) = delete;            // neighbor blocks belong to this graph's pool
+    CoreGraph &operator=(const CoreGraph &) = delete;
 
     // ==============================
     //  User Operations
@@ -35,6 +51,13 @@ public:
     bool addFriend(int a, int b); // Add undirected friendship
     bool removeFriend(int a, int b);
 
+    // Adds many friendships at once: the pairs are symmetrized, sorted and
+    // deduplicated in parallel, then every touched user's neighbor list is
+    // rebuilt with one allocation. Pairs with a missing user or a == b are
+    // skipped. Returns the friendships that were actually inserted, each
+    // once as (lower id, higher id), in ascending order.
+    std::vector<std::pair<int, int>> addFriendsBulk(const std::vector<std::pair<int, int>> &edges);
+
     // ==============================
     //  Interest Operations
     // ==============================
@@ -42,26 +65,117 @@ public:
     bool addInterests(int userId, const std::vector<std::string> &interests); // Add multiple
     std::unordered_set<std::string> getInterests(int userId) const;           // Get all interests
     void printInterests(int userId) const;                                    // Print interests
+    const InterestIndex &interestIndex() const { return interestIdx; }        // Interest -> users postings
+
+    // Users matching an interest query (terms are lowercased like stored
+    // interests), highest degree first then lowest id, at most topK of them.
+    // matches receives the total number of matching users.
+    std::vector<int> searchInterests(const InterestQuery &query, int topK, size_t *matches = nullptr) const;
 
     // ==============================
     //  Accessors
     // ==============================
     std::vector<int> getFriends(int id) const;                             // Return friend IDs (sorted)
     std::vector<int> listAllUsers() const;                                 // Return all user IDs (sorted)
-    std::unordered_map<int, std::unordered_set<int>> getAdjacency() const; // Return adjacency
+    const std::vector<int> &userIds() const { return sortedIds; }          // Same, in place (no copy)
+    std::unordered_map<int, std::unordered_set<int>> getAdjacency() const; // Return adjacency (copy)
+    const NeighborList &neighbors(int id) const;                           // Friend IDs in place (no copy)
+    size_t degree(int id) const;                                           // Number of friends
+    bool areFriends(int a, int b) const;                                   // Edge test
+    size_t mutualCount(int a, int b) const;                                // |friends(a) ∩ friends(b)|
+    std::vector<int> mutualFriends(int a, int b) const;                    // friends(a) ∩ friends(b) (sorted)
+
+    // Dense indices: every user also has an internal index in [0, denseBound()).
+    // Indices are stable until the next removeUser (which may compact them),
+    // so they suit per-query scratch arrays but must not be stored.
+    int denseIndex(int id) const;                                          // -1 if the user is missing
+    size_t denseBound() const { return users.size(); }
+
+    // Every name lives once in this arena; User::name and the name indexes
+    // in Persistence and Tools view into it. Views stay valid until
+    // names().generation() changes (clear, or removeUser compacting it).
+    const NameArena &names() const { return nameArena; }
+
+    // ==============================
+    //  Snapshots
+    // ==============================
+    uint64_t version() const { return ver; }             // Bumped on every user/friendship change
+    std::shared_ptr<const CsrGraph> snapshot() const;    // CSR copy, cached until the next change
+
+    // Compressed snapshot mode for graphs that must fit a tight memory
+    // budget. When on, the cached snapshot is a delta-varint CompressedCsr
+    // and the plain CSR is no longer kept: snapshot() still builds one for
+    // kernels that need random access, but it lives only as long as its
+    // callers hold it. Off by default.
+    void setCompressedSnapshots(bool on);
+    bool compressedSnapshots() const { return compressedSnaps; }
+    std::shared_ptr<const CompressedCsr> compressedSnapshot() const; // cached until the next change in compressed mode
+
+    // Full image (profiles + friends) for long readers such as saves. Only
+    // users changed since the previous pin are copied; the rest is shared
+    // with it. Like snapshot(), pinning reads the live graph and must not
+    // overlap writers; the returned version can then be read from any
+    // thread while the graph keeps changing.
+    std::shared_ptr<const GraphVersion> pin() const;
+
+    // Per-user modification clock for fine-grained cache invalidation.
+    // A user is touched when its friend list or interests change; an interest
+    // change also touches the user's friends, so anything derived from a
+    // user's two-hop neighborhood is fresh iff the user and all its friends
+    // were last touched at or before the time it was computed. New users
+    // (including re-created ids) always start newer than any earlier stamp.
+    uint64_t modClock() const { return clock; }          // Current clock value
+    uint64_t userModified(int id) const;                 // Last touch of a user (UINT64_MAX if missing)
 
     // ==============================
     //  Helpers
     // ==============================
     void clear();                 // Clear users + edges
     void printUser(int id) const; // Print user details
+    void reportMemory(MemoryReport &report) const; // Bytes/objects for users, interests, adjacency
 
 private:
     int nextId;
-    std::unordered_map<int, User> users;
-    std::unordered_map<int, std::unordered_set<int>> adj;
+    uint64_t ver;
+    uint64_t clock;  // per-user modification clock (see modClock)
+
+    // Users and their neighbor lists live in vectors indexed by dense index.
+    // External ids map to dense indices through a direct table while ids stay
+    // reasonably dense, and through a hash map beyond it. Removed users leave
+    // a tombstone (id 0) until compact() closes the gaps. Hot per-user data
+    // (neighbor lists, modification stamps) is kept apart from the profiles.
+    std::vector<User> users;                   // cold: id, name, interests
+    std::vector<NeighborList> adj;             // hot: friend lists
+    std::vector<uint64_t> stamps;              // hot: last touch (see modClock)
+    std::vector<int> directIndex;              // id -> dense index (-1 if absent), ids < size()
+    std::unordered_map<int, int> sparseIndex;  // ids beyond directIndex
+    std::vector<int> sortedIds;                // live ids, ascending
+    size_t removedSlots;                       // tombstones in users/adj
+    BlockPool pool; // backing storage for every NeighborList in adj
+    NameArena nameArena;
+    InterestIndex interestIdx;
+
+    mutable std::mutex snapMutex;
+    mutable std::shared_ptr<const CsrGraph> snap;             // plain mode
+    mutable std::weak_ptr<const CsrGraph> looseSnap;          // compressed mode: reused while callers hold it
+    mutable std::shared_ptr<const CompressedCsr> packedSnap;  // compressed mode
+    bool compressedSnaps;
+
+    // Copy-on-write state for pin(): dense indices changed since the last
+    // published version, or a full republish after compact()/clear()
+    mutable std::mutex versionMutex;
+    mutable std::shared_ptr<const GraphVersion> published;
+    mutable std::vector<int> dirtySlots;
+    mutable std::vector<char> dirtyMark;      // per dense index: already in dirtySlots
+    mutable bool orderDirty;                  // users added or removed
+    mutable bool republishAll;                // dense indices renumbered
 
     std::string normalize(const std::string &s) const; // lowercase helper
+    void touch(int id);                                // stamp a user with ++clock
+    void markDirty(int index);                         // index changed since the last pin()
+    void mapId(int id, int index);                     // record id -> dense index
+    void unmapId(int id);
+    void compact();                                    // drop tombstones, renumber dense indices
 };
 
 #endif // CORE_GRAPH_H
\ No newline at end of file
@@ -0,0 +1,32 @@
+#include "CsrGraph.h"
+#include "CoreGraph.h"
+#include <algorithm>
+
+std::shared_ptr<const CsrGraph> CsrGraph::build(const CoreGraph &graph) {
+    std::shared_ptr<CsrGraph> g(new CsrGraph());
+    g->ver = graph.version();
+    g->ids = graph.listAllUsers();
+
+    size_t n = g->ids.size();
+    g->offsets.assign(n + 1, 0);
+    for (size_t u = 0; u < n; ++u) g->offsets[u + 1] = g->offsets[u] + graph.degree(g->ids[u]);
+
+    g->nbrs.reserve(g->offsets[n]);
+    for (size_t u = 0; u < n; ++u) {
+        size_t start = g->nbrs.size();
+        graph.neighbors(g->ids[u]).appendSorted(g->nbrs);
+        // ids are ascending, so sorted ids map to sorted indices
+        for (size_t k = start; k < g->nbrs.size(); ++k) g->nbrs[k] = g->indexOf(g->nbrs[k]);
+    }
+    return g;
+}
+
+int CsrGraph::indexOf(int id) const {
+    auto it = std::lower_bound(ids.begin(), ids.end(), id);
+    if (it == ids.end() || *it != id) return -1;
+    return (int)(it - ids.begin());
+}
+
+bool CsrGraph::hasEdge(int u, int v) const {
+    return std::binary_search(begin(u), end(u), v);
+}
@@ -0,0 +1,48 @@
+#ifndef CSR_GRAPH_H
+#define CSR_GRAPH_H
+
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+
+class CoreGraph;
+
+/**
+ * @class CsrGraph
+ * @brief Immutable compressed-sparse-row copy of the friendship graph.
+ *
+ * Users are renumbered to dense indices 0..n-1 in ascending id order, so a
+ * neighbor range sorted by index is also sorted by user id. Analytics run on
+ * this view: it is contiguous, safe to share between threads, and stays
+ * consistent while the live CoreGraph keeps changing.
+ */
+class CsrGraph {
+public:
+    /**
+     * @brief Builds a snapshot of the current graph.
+     */
+    static std::shared_ptr<const CsrGraph> build(const CoreGraph &graph);
+
+    uint64_t version() const { return ver; }          ///< CoreGraph::version() at build time
+    int numNodes() const { return (int)ids.size(); }
+    size_t numEdges() const { return nbrs.size() / 2; } ///< Undirected edge count
+
+    int idOf(int u) const { return ids[u]; }
+    int indexOf(int id) const;                        ///< Dense index of a user id, or -1
+
+    uint32_t degree(int u) const { return (uint32_t)(offsets[u + 1] - offsets[u]); }
+    const int *begin(int u) const { return nbrs.data() + offsets[u]; }
+    const int *end(int u) const { return nbrs.data() + offsets[u + 1]; }
+    bool hasEdge(int u, int v) const;                 ///< Binary search in u's range
+
+private:
+    CsrGraph() : ver(0) {}
+
+    std::vector<int> ids;         // dense index -> user id (ascending)
+    std::vector<size_t> offsets;  // n + 1 entries
+    std::vector<int> nbrs;        // dense neighbor indices, sorted per row
+    uint64_t ver;
+};
+
+#endif // CSR_GRAPH_H
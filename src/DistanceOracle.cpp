@@ -0,0 +1,205 @@
+#include "DistanceOracle.h"
+#include "CoreGraph.h"
+#include "CsrGraph.h"
+#include "Parallel.h"
+#include "MemoryReport.h"
+#include <algorithm>
+#include <cstdlib>
+
+DistanceOracle::DistanceOracle(const CoreGraph *graph)
+    : G(graph), numLandmarks(16), threshold(1000), building(false) {}
+
+DistanceOracle::~DistanceOracle() {
+    if (builder.joinable()) builder.join();
+}
+
+
+// =============================================================
+// 1️⃣ Index Construction (one BFS per landmark)
+// =============================================================
+std::shared_ptr<const DistanceOracle::Index>
+DistanceOracle::makeIndex(std::shared_ptr<const CsrGraph> snap, int landmarks) {
+    std::shared_ptr<Index> ix(new Index());
+    const CsrGraph &g = *snap;
+    int n = g.numNodes();
+    ix->snap = std::move(snap);
+
+    // Landmarks: highest degree first, ties by lower id
+    std::vector<int> order(n);
+    for (int u = 0; u < n; ++u) order[u] = u;
+    int L = std::min(landmarks, n);
+    std::partial_sort(order.begin(), order.begin() + L, order.end(), [&](int a, int b) {
+        if (g.degree(a) != g.degree(b)) return g.degree(a) > g.degree(b);
+        return a < b;
+    });
+    ix->landmarks.assign(order.begin(), order.begin() + L);
+    ix->dist.assign((size_t)n * L, kUnreached);
+
+    parallelFor(0, L, 1, [&](size_t lo, size_t hi, unsigned) {
+        std::vector<int> frontier, next;
+        for (size_t l = lo; l < hi; ++l) {
+            int root = ix->landmarks[l];
+            ix->dist[(size_t)root * L + l] = 0;
+            frontier.assign(1, root);
+            for (uint16_t depth = 1; !frontier.empty() && depth < kUnreached; ++depth) {
+                next.clear();
+                for (int u : frontier) {
+                    for (const int *p = g.begin(u); p != g.end(u); ++p) {
+                        uint16_t &d = ix->dist[(size_t)*p * L + l];
+                        if (d != kUnreached) continue;
+                        d = depth;
+                        next.push_back(*p);
+                    }
+                }
+                frontier.swap(next);
+            }
+        }
+    });
+    return ix;
+}
+
+bool DistanceOracle::build(int landmarks) {
+    if (!G) return false;
+    numLandmarks = std::max(1, std::min(landmarks, 64));
+    install(makeIndex(G->snapshot(), numLandmarks));
+    return true;
+}
+
+void DistanceOracle::rebuildAsync() {
+    if (!G || building.exchange(true)) return;
+    if (builder.joinable()) builder.join(); // previous build already finished
+    // The snapshot is taken here: the live graph is not safe to read from
+    // another thread, the immutable CSR copy is.
+    auto snap = G->snapshot();
+    int L = numLandmarks;
+    builder = std::thread([this, snap, L]() {
+        install(makeIndex(snap, L));
+        building.store(false);
+    });
+}
+
+void DistanceOracle::maybeRebuild() {
+    auto ix = current();
+    if (!ix || building.load()) return;
+    if (G->version() - ix->snap->version() >= threshold) rebuildAsync();
+}
+
+bool DistanceOracle::ready() const {
+    return current() != nullptr;
+}
+
+std::shared_ptr<const DistanceOracle::Index> DistanceOracle::current() const {
+    std::lock_guard<std::mutex> lock(indexMutex);
+    return idx;
+}
+
+// A background rebuild can finish after a synchronous build() of a newer
+// snapshot; the older index must not replace it.
+void DistanceOracle::install(std::shared_ptr<const Index> ix) {
+    std::lock_guard<std::mutex> lock(indexMutex);
+    if (!idx || ix->snap->version() >= idx->snap->version()) idx = std::move(ix);
+}
+
+
+// =============================================================
+// 2️⃣ Queries
+// =============================================================
+DistanceEstimate DistanceOracle::estimate(int a, int b) const {
+    DistanceEstimate res{0, -1, false, true};
+    auto ix = current();
+    if (!ix) return res;
+    res.stale = G && G->version() != ix->snap->version();
+
+    const CsrGraph &g = *ix->snap;
+    int u = g.indexOf(a), v = g.indexOf(b);
+    if (u < 0 || v < 0) return res;
+    if (u == v) {
+        res.upper = 0;
+        res.exact = true;
+        return res;
+    }
+
+    size_t L = ix->landmarks.size();
+    const uint16_t *du = &ix->dist[(size_t)u * L];
+    const uint16_t *dv = &ix->dist[(size_t)v * L];
+    int lower = 1, upper = -1;
+    for (size_t l = 0; l < L; ++l) {
+        bool ru = du[l] != kUnreached, rv = dv[l] != kUnreached;
+        if (ru != rv) {
+            // A landmark reaches exactly one of them: different components
+            res.lower = res.upper = -1;
+            res.exact = true;
+            return res;
+        }
+        if (!ru) continue;
+        int sum = du[l] + dv[l];
+        if (upper < 0 || sum < upper) upper = sum;
+        lower = std::max(lower, std::abs((int)du[l] - (int)dv[l]));
+    }
+    res.lower = lower;
+    res.upper = upper;
+    res.exact = upper >= 0 && lower == upper;
+    return res;
+}
+
+// Level-synchronous BFS that stops at depth limit. slot(v) maps a node to
+// [0, n) for the visited marks; forEachNeighbor(u, visit) calls visit(v)
+// for every neighbor v of u.
+template <class Slot, class ForEachNeighbor>
+static int bfsDistance(size_t n, int src, int dst, int limit, Slot &&slot, ForEachNeighbor &&forEachNeighbor) {
+    std::vector<char> seen(n, 0);
+    std::vector<int> frontier(1, src), next;
+    seen[slot(src)] = 1;
+    bool found = false;
+    for (int depth = 1; !frontier.empty() && depth <= limit; ++depth) {
+        next.clear();
+        for (int u : frontier) {
+            forEachNeighbor(u, [&](int v) {
+                char &mark = seen[slot(v)];
+                if (mark) return;
+                if (v == dst) found = true;
+                mark = 1;
+                next.push_back(v);
+            });
+            if (found) return depth;
+        }
+        frontier.swap(next);
+    }
+    return -1;
+}
+
+int DistanceOracle::exactDistance(int a, int b) const {
+    if (!G || !G->userExists(a) || !G->userExists(b)) return -1;
+    if (a == b) return 0;
+
+    DistanceEstimate est = estimate(a, b);
+    if (!est.stale && est.exact) return est.upper;
+
+    // Fresh index: its snapshot is the current graph, so search it, never
+    // deeper than the upper bound
+    auto ix = current();
+    if (ix && ix->snap->version() == G->version()) {
+        const CsrGraph &g = *ix->snap;
+        int limit = !est.stale && est.upper >= 0 ? est.upper : g.numNodes();
+        return bfsDistance(
+            g.numNodes(), g.indexOf(a), g.indexOf(b), limit, [](int u) { return u; },
+            [&](int u, auto &&visit) {
+                for (const int *p = g.begin(u); p != g.end(u); ++p) visit(*p);
+            });
+    }
+
+    // Stale or missing index: search the live graph rather than paying for
+    // a fresh CSR snapshot after every write
+    return bfsDistance(
+        G->denseBound(), a, b, (int)G->denseBound(), [&](int id) { return G->denseIndex(id); },
+        [&](int id, auto &&visit) {
+            for (int f : G->neighbors(id)) visit(f);
+        });
+}
+
+void DistanceOracle::reportMemory(MemoryReport &report) const {
+    auto ix = current();
+    if (!ix) return;
+    report.add("distance.landmarkDist", MemoryReport::vectorBytes(ix->dist), ix->dist.size());
+    report.add("distance.landmarks", MemoryReport::vectorBytes(ix->landmarks), ix->landmarks.size());
+}
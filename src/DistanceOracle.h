@@ -0,0 +1,115 @@
+#ifndef DISTANCE_ORACLE_H
+#define DISTANCE_ORACLE_H
+
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <cstdint>
+
+class CoreGraph;
+class CsrGraph;
+class MemoryReport;
+
+/**
+ * @brief Degrees-of-separation answer from the oracle.
+ *
+ * upper = -1 means no landmark connects the two users. When exact is set,
+ * lower == upper is the true distance (or both are -1: not connected).
+ */
+struct DistanceEstimate {
+    int lower;
+    int upper;
+    bool exact;
+    bool stale;   ///< The graph changed since the index was built
+};
+
+/**
+ * @class DistanceOracle
+ * @brief Landmark index for constant-time distance estimates.
+ *
+ * The highest-degree users become landmarks and one BFS per landmark
+ * stores every user's distance to it. For users a and b the triangle
+ * inequality bounds the distance:
+ *   max_l |d(a,l) - d(b,l)|  <=  d(a,b)  <=  min_l d(a,l) + d(l,b)
+ * and in small-world graphs the bounds usually meet, making the answer exact.
+ *
+ * The index is built on a CSR snapshot. Once enough mutations accumulate,
+ * maybeRebuild() starts a background rebuild; queries keep using the old
+ * index until the new one is swapped in.
+ */
+class DistanceOracle {
+public:
+    explicit DistanceOracle(const CoreGraph *graph);
+    ~DistanceOracle();
+
+    DistanceOracle(const DistanceOracle &) = delete;
+    DistanceOracle &operator=(const DistanceOracle &) = delete;
+
+    /**
+     * @brief Builds the index synchronously.
+     * @param landmarks Number of landmarks (clamped to [1, 64]).
+     * @return false if there is no graph.
+     */
+    bool build(int landmarks = 16);
+
+    /**
+     * @brief Starts a background rebuild unless one is already running.
+     */
+    void rebuildAsync();
+
+    /**
+     * @brief Rebuilds in the background once the graph has changed at least
+     * rebuildThreshold() times since the last build. No-op before build().
+     */
+    void maybeRebuild();
+
+    void setRebuildThreshold(uint64_t mutations) { threshold = mutations ? mutations : 1; }
+    uint64_t rebuildThreshold() const { return threshold; }
+
+    bool ready() const;      ///< An index has been built
+    bool rebuilding() const { return building.load(); }
+
+    /**
+     * @brief Bounds from the index only (no graph traversal).
+     * Users added after the build get {0, -1, false, true}.
+     */
+    DistanceEstimate estimate(int a, int b) const;
+
+    /**
+     * @brief Exact distance: the index answer when it is tight and fresh,
+     * otherwise a BFS cut off at the upper bound, on the index snapshot
+     * while it matches the graph and on the live graph once it is stale.
+     * @return Hop count, or -1 if a user is missing or they are not connected.
+     */
+    int exactDistance(int a, int b) const;
+
+    // Bytes held by the current index
+    void reportMemory(MemoryReport &report) const;
+
+private:
+    static constexpr uint16_t kUnreached = 0xFFFF;
+
+    struct Index {
+        std::shared_ptr<const CsrGraph> snap;
+        std::vector<int> landmarks;   // dense indices into snap
+        std::vector<uint16_t> dist;   // dist[u * L + l]
+    };
+
+    const CoreGraph *G;
+    int numLandmarks;
+    uint64_t threshold;
+
+    mutable std::mutex indexMutex;  // guards idx (the pointer, not the index)
+    std::shared_ptr<const Index> idx;
+
+    std::atomic<bool> building;
+    std::thread builder;
+
+    std::shared_ptr<const Index> current() const;
+    void install(std::shared_ptr<const Index> ix);   // Keeps whichever index is newer
+    static std::shared_ptr<const Index> makeIndex(std::shared_ptr<const CsrGraph> snap, int landmarks);
+};
+
+#endif // DISTANCE_ORACLE_H
@@ -1,12 +1,22 @@
 #include "GraphAlgorithms.h"
 #include "CoreGraph.h"
+#include "CsrGraph.h"
+#include "CompressedCsr.h"
+#include "SetIntersection.h"
+#include "Parallel.h"
 #include <queue>
 #include <unordered_map>
 #include <unordered_set>
 #include <algorithm>
 #include <iostream>
+#include <atomic>
+#include <random>
+#include <cmath>
 
-GraphAlgorithms::GraphAlgorithms(CoreGraph *graph) : G(graph) {}
+GraphAlgorithms::GraphAlgorithms(CoreGraph *graph)
+    : G(graph), triTotals{0, 0, 0.0, true, 0, 0.0},
+      prDamping(0), prTolerance(0), prMaxIterations(0), prIterations(0), prResidual(0),
+      commResult{{}, 0.0, 0}, coreVer(0), coreValid(false), coreMax(0) {}
 
 
 // =============================================================
@@ -16,6 +26,7 @@ GraphAlgorithms::GraphAlgorithms(CoreGraph *graph) : G(graph) {}
 std::vector<int> GraphAlgorithms::shortestPath(int src, int dst) {
     std::vector<int> empty;
     if (!G || !G->getUser(src) || !G->getUser(dst)) return empty;
+    if (G->compressedSnapshots()) return shortestPathOf(*G->compressedSnapshot(), src, dst);
 
     std::unordered_map<int, int> parent;
     std::unordered_set<int> visited;
@@ -26,16 +37,12 @@ std::vector<int> GraphAlgorithms::shortestPath(int src, int dst) {
     parent[src] = -1;
 
     bool found = false;
-    auto adj = G->getAdjacency();
 
     while (!q.empty()) {
         int u = q.front(); q.pop();
         if (u == dst) { found = true; break; }
 
-        auto it = adj.find(u);
-        if (it == adj.end()) continue;
-
-        for (int v : it->second) {
+        for (int v : G->neighbors(u)) {
             if (!visited.count(v)) {
                 visited.insert(v);
                 parent[v] = u;
@@ -53,48 +60,95 @@ std::vector<int> GraphAlgorithms::shortestPath(int src, int dst) {
     return path;
 }
 
+// Same search over dense indices, with the parent links in a flat array
+std::vector<int> GraphAlgorithms::shortestPathOf(const CompressedCsr &g, int src, int dst) {
+    std::vector<int> path;
+    int s = g.indexOf(src), t = g.indexOf(dst);
+    if (s < 0 || t < 0) return path;
+
+    std::vector<int> parent(g.numNodes(), -2);
+    std::vector<int> queue(1, s);
+    parent[s] = -1;
+    for (size_t head = 0; head < queue.size() && parent[t] == -2; ++head) {
+        int u = queue[head];
+        g.forEachNeighbor(u, [&](int v) {
+            if (parent[v] != -2) return;
+            parent[v] = u;
+            queue.push_back(v);
+        });
+    }
+    if (parent[t] == -2) return path;
+
+    for (int cur = t; cur != -1; cur = parent[cur]) path.push_back(g.idOf(cur));
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+size_t GraphAlgorithms::mutualCount(int a, int b) {
+    if (!G) return 0;
+    if (!G->compressedSnapshots()) return G->mutualCount(a, b);
+    return mutualCountOf(*G->compressedSnapshot(), a, b);
+}
+
+size_t GraphAlgorithms::mutualCountOf(const CompressedCsr &g, int a, int b) {
+    int u = g.indexOf(a), v = g.indexOf(b);
+    if (u < 0 || v < 0) return 0;
+    return g.intersectCount(u, v);
+}
+
 
 // =============================================================
 // 2️⃣ Connected Components (Community Detection)
 // =============================================================
 // Groups users into disconnected friendship communities.
 std::vector<std::vector<int>> GraphAlgorithms::connectedComponents() {
-    std::vector<std::vector<int>> comps;
-    if (!G) return comps;
-
-    std::unordered_set<int> seen;
-    auto adj = G->getAdjacency();
-
-    for (int u : G->listAllUsers()) {
-        if (seen.count(u)) continue;
-
-        std::vector<int> comp;
-        std::queue<int> q;
-        q.push(u);
-        seen.insert(u);
-
-        while (!q.empty()) {
-            int x = q.front(); q.pop();
-            comp.push_back(x);
+    if (!G) return std::vector<std::vector<int>>();
+    if (G->compressedSnapshots()) return componentsOf(*G->compressedSnapshot());
+    return componentsOf(*G->snapshot());
+}
 
-            auto it = adj.find(x);
-            if (it == adj.end()) continue;
+// Dense indices follow ascending ids, so components come out ordered by
+// their smallest member, each sorted ascending. forEach(x, visit) calls
+// visit(y) for every neighbor y of x.
+template <class Graph, class ForEach>
+static std::vector<std::vector<int>> componentsIn(const Graph &g, ForEach &&forEach) {
+    std::vector<std::vector<int>> comps;
+    int n = g.numNodes();
+    std::vector<char> seen(n, 0);
+    std::vector<int> queue;
+    queue.reserve(n);
 
-            for (int v : it->second) {
-                if (!seen.count(v)) {
-                    seen.insert(v);
-                    q.push(v);
-                }
-            }
+    for (int s = 0; s < n; ++s) {
+        if (seen[s]) continue;
+        queue.clear();
+        queue.push_back(s);
+        seen[s] = 1;
+        for (size_t head = 0; head < queue.size(); ++head) {
+            forEach(queue[head], [&](int y) {
+                if (seen[y]) return;
+                seen[y] = 1;
+                queue.push_back(y);
+            });
         }
-
-        std::sort(comp.begin(), comp.end());
-        comps.push_back(comp);
+        std::sort(queue.begin(), queue.end());
+        std::vector<int> comp(queue.size());
+        for (size_t i = 0; i < queue.size(); ++i) comp[i] = g.idOf(queue[i]);
+        comps.push_back(std::move(comp));
     }
 
     return comps;
 }
 
+std::vector<std::vector<int>> GraphAlgorithms::componentsOf(const CsrGraph &g) {
+    return componentsIn(g, [&](int x, auto &&visit) {
+        for (const int *p = g.begin(x); p != g.end(x); ++p) visit(*p);
+    });
+}
+
+std::vector<std::vector<int>> GraphAlgorithms::componentsOf(const CompressedCsr &g) {
+    return componentsIn(g, [&](int x, auto &&visit) { g.forEachNeighbor(x, visit); });
+}
+
 
 // =============================================================
 // 3️⃣ Influencer by Degree
@@ -103,13 +157,11 @@ std::vector<std::vector<int>> GraphAlgorithms::connectedComponents() {
 int GraphAlgorithms::influencerByDegree() {
     if (!G) return -1;
 
-    auto adj = G->getAdjacency();
     int best = -1;
     size_t bestDeg = 0;
 
-    for (auto &p : adj) {
-        int u = p.first;
-        size_t deg = p.second.size();
+    for (int u : G->listAllUsers()) {
+        size_t deg = G->degree(u);
 
         if (deg > bestDeg || (deg == bestDeg && (best == -1 || u < best))) {
             bestDeg = deg;
@@ -164,4 +216,911 @@ int GraphAlgorithms::influencerByInterestOverlap() {
     }
 
     return bestUser;
+}
+
+
+// =============================================================
+// 5️⃣ Triangle Counting & Clustering Coefficients
+// =============================================================
+// Exact counting orients every edge from lower to higher (degree, index)
+// rank, so each triangle is found once and hubs get short out-lists.
+// Each oriented edge (u,v) contributes |out(u) ∩ out(v)| triangles.
+static uint64_t countTriangles(const CsrGraph &g, std::vector<uint64_t> &perNode) {
+    int n = g.numNodes();
+    auto before = [&](int a, int b) {
+        uint32_t da = g.degree(a), db = g.degree(b);
+        return da < db || (da == db && a < b);
+    };
+
+    // Oriented CSR (out-lists stay sorted because they are filtered in order)
+    std::vector<size_t> outOff(n + 1, 0);
+    parallelFor(0, n, 1024, [&](size_t lo, size_t hi, unsigned) {
+        for (size_t u = lo; u < hi; ++u) {
+            size_t c = 0;
+            for (const int *p = g.begin((int)u); p != g.end((int)u); ++p) c += before((int)u, *p);
+            outOff[u + 1] = c;
+        }
+    });
+    for (int u = 0; u < n; ++u) outOff[u + 1] += outOff[u];
+    std::vector<int> outNbr(outOff[n]);
+    parallelFor(0, n, 1024, [&](size_t lo, size_t hi, unsigned) {
+        for (size_t u = lo; u < hi; ++u) {
+            size_t k = outOff[u];
+            for (const int *p = g.begin((int)u); p != g.end((int)u); ++p)
+                if (before((int)u, *p)) outNbr[k++] = *p;
+        }
+    });
+
+    std::unique_ptr<std::atomic<uint64_t>[]> counts(new std::atomic<uint64_t>[n]);
+    for (int u = 0; u < n; ++u) counts[u].store(0, std::memory_order_relaxed);
+    ParallelScope scope;
+    std::vector<std::vector<int>> scratch(scope.workers());
+    std::atomic<uint64_t> total(0);
+
+    parallelFor(0, n, 256, [&](size_t lo, size_t hi, unsigned worker) {
+        std::vector<int> &buf = scratch[worker];
+        uint64_t local = 0;
+        for (size_t u = lo; u < hi; ++u) {
+            const int *ub = outNbr.data() + outOff[u];
+            size_t ud = outOff[u + 1] - outOff[u];
+            if (ud < 2) continue;
+            if (buf.size() < ud) buf.resize(ud);
+            for (size_t i = 0; i < ud; ++i) {
+                int v = ub[i];
+                const int *vb = outNbr.data() + outOff[v];
+                size_t vd = outOff[v + 1] - outOff[v];
+                size_t found = intersectSorted(ub, ud, vb, vd, buf.data());
+                if (found == 0) continue;
+                local += found;
+                counts[u].fetch_add(found, std::memory_order_relaxed);
+                counts[v].fetch_add(found, std::memory_order_relaxed);
+                for (size_t k = 0; k < found; ++k) counts[buf[k]].fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        total.fetch_add(local, std::memory_order_relaxed);
+    });
+
+    perNode.resize(n);
+    for (int u = 0; u < n; ++u) perNode[u] = counts[u].load(std::memory_order_relaxed);
+    return total.load();
+}
+
+static uint64_t wedgesOf(uint64_t d) { return d * (d > 0 ? d - 1 : 0) / 2; }
+
+TriangleStats GraphAlgorithms::triangleStatsOf(const CsrGraph &g, std::vector<uint64_t> *perNode) {
+    uint64_t wedges = 0;
+    for (int u = 0; u < g.numNodes(); ++u) wedges += wedgesOf(g.degree(u));
+
+    std::vector<uint64_t> local;
+    TriangleStats res{0, wedges, 0.0, true, 0, 0.0};
+    res.triangles = countTriangles(g, perNode ? *perNode : local);
+    res.transitivity = wedges ? 3.0 * (double)res.triangles / (double)wedges : 0.0;
+    return res;
+}
+
+void GraphAlgorithms::ensureTriangles() {
+    auto snap = G->snapshot();
+    if (triSnap == snap) return;
+    triTotals = triangleStatsOf(*snap, &triPerNode);
+    triSnap = snap;
+}
+
+TriangleStats GraphAlgorithms::triangleStats() {
+    if (!G) return TriangleStats{0, 0, 0.0, true, 0, 0.0};
+    ensureTriangles();
+    return triTotals;
+}
+
+// Picks wedge centers with probability proportional to d(d-1)/2, then two
+// distinct friends of the center, and checks whether they are friends.
+TriangleStats GraphAlgorithms::approxTriangleStats(uint64_t samples, uint32_t seed) {
+    TriangleStats res{0, 0, 0.0, false, samples, 0.0};
+    if (!G || samples == 0) return res;
+    auto snap = G->snapshot();
+    const CsrGraph &g = *snap;
+    int n = g.numNodes();
+
+    std::vector<uint64_t> cum(n + 1, 0);
+    for (int u = 0; u < n; ++u) cum[u + 1] = cum[u] + wedgesOf(g.degree(u));
+    res.wedges = cum[n];
+    if (res.wedges == 0) return res;
+
+    // Fixed number of equal slices so the result does not depend on the worker count.
+    const uint64_t kSlices = 64;
+    std::vector<uint64_t> closedPerSlice(kSlices, 0);
+    parallelFor(0, kSlices, 1, [&](size_t lo, size_t hi, unsigned) {
+        for (size_t s = lo; s < hi; ++s) {
+            uint64_t count = samples / kSlices + (s < samples % kSlices ? 1 : 0);
+            std::mt19937_64 rng(((uint64_t)seed << 32) ^ (s * 0x9E3779B97F4A7C15ull));
+            std::uniform_int_distribution<uint64_t> pickWedge(0, res.wedges - 1);
+            uint64_t closed = 0;
+            for (uint64_t i = 0; i < count; ++i) {
+                uint64_t r = pickWedge(rng);
+                int c = (int)(std::upper_bound(cum.begin(), cum.end(), r) - cum.begin()) - 1;
+                uint32_t d = g.degree(c);
+                std::uniform_int_distribution<uint32_t> pickA(0, d - 1), pickB(0, d - 2);
+                uint32_t a = pickA(rng), b = pickB(rng);
+                if (b >= a) ++b;
+                closed += g.hasEdge(g.begin(c)[a], g.begin(c)[b]);
+            }
+            closedPerSlice[s] = closed;
+        }
+    });
+
+    uint64_t closed = 0;
+    for (uint64_t c : closedPerSlice) closed += c;
+    double p = (double)closed / (double)samples;
+    res.transitivity = p;
+    res.triangles = (uint64_t)std::llround(p * (double)res.wedges / 3.0);
+    res.stdError = std::sqrt(p * (1.0 - p) / (double)samples);
+    return res;
+}
+
+long long GraphAlgorithms::trianglesOf(int userId) {
+    if (!G || !G->userExists(userId)) return -1;
+    ensureTriangles();
+    int u = triSnap->indexOf(userId);
+    return u < 0 ? -1 : (long long)triPerNode[u];
+}
+
+double GraphAlgorithms::localClustering(int userId) {
+    if (!G || !G->userExists(userId)) return -1.0;
+    ensureTriangles();
+    int u = triSnap->indexOf(userId);
+    if (u < 0) return -1.0;
+    uint64_t w = wedgesOf(triSnap->degree(u));
+    return w ? (double)triPerNode[u] / (double)w : 0.0;
+}
+
+std::vector<std::pair<int, double>> GraphAlgorithms::mostClustered(int topN, int minDegree) {
+    std::vector<std::pair<int, double>> res;
+    if (!G || topN <= 0) return res;
+    ensureTriangles();
+    const CsrGraph &g = *triSnap;
+    if (minDegree < 2) minDegree = 2;
+
+    for (int u = 0; u < g.numNodes(); ++u) {
+        uint32_t d = g.degree(u);
+        if ((int)d < minDegree) continue;
+        res.push_back({g.idOf(u), (double)triPerNode[u] / (double)wedgesOf(d)});
+    }
+    auto better = [](const std::pair<int, double> &a, const std::pair<int, double> &b) {
+        if (a.second != b.second) return a.second > b.second;
+        return a.first < b.first;
+    };
+    if ((int)res.size() > topN) {
+        std::partial_sort(res.begin(), res.begin() + topN, res.end(), better);
+        res.resize(topN);
+    } else {
+        std::sort(res.begin(), res.end(), better);
+    }
+    return res;
+}
+
+
+// =============================================================
+// 6️⃣ PageRank Influencers
+// =============================================================
+// Each iteration first publishes contrib[u] = rank[u] / deg(u), then every
+// user pulls the sum of its friends' contributions. Pulling means each
+// thread only writes its own users, so no atomics are needed.
+std::vector<double> GraphAlgorithms::pageRankOf(const CsrGraph &g, double damping, double tolerance,
+                                                int maxIterations, int *iterations, double *residualOut,
+                                                const std::atomic<bool> *cancel) {
+    int n = g.numNodes();
+    std::vector<double> rank(n, n ? 1.0 / n : 0.0), next(n), contrib(n);
+    const size_t grain = 2048;
+    auto plus = [](double a, double b) { return a + b; };
+
+    int iter = 0;
+    double residual = 0.0;
+    while (n > 0 && iter < maxIterations) {
+        if (cancel && cancel->load(std::memory_order_relaxed)) break;
+        // Phase 1: contributions and the rank held by dangling users
+        double dangling = parallelReduce(0, n, grain, 0.0, [&](size_t lo, size_t hi) {
+            double sum = 0.0;
+            for (size_t u = lo; u < hi; ++u) {
+                uint32_t d = g.degree((int)u);
+                if (d) contrib[u] = rank[u] / d;
+                else { contrib[u] = 0.0; sum += rank[u]; }
+            }
+            return sum;
+        }, plus);
+        double base = (1.0 - damping) / n + damping * dangling / n;
+
+        // Phase 2: pull
+        residual = parallelReduce(0, n, grain, 0.0, [&](size_t lo, size_t hi) {
+            double diff = 0.0;
+            for (size_t v = lo; v < hi; ++v) {
+                double sum = 0.0;
+                for (const int *p = g.begin((int)v); p != g.end((int)v); ++p) sum += contrib[*p];
+                next[v] = base + damping * sum;
+                diff += std::fabs(next[v] - rank[v]);
+            }
+            return diff;
+        }, plus);
+        rank.swap(next);
+        ++iter;
+        if (residual < tolerance) break;
+    }
+
+    if (iterations) *iterations = iter;
+    if (residualOut) *residualOut = residual;
+    return rank;
+}
+
+void GraphAlgorithms::ensurePageRank(double damping, double tolerance, int maxIterations) {
+    auto snap = G->snapshot();
+    if (prSnap == snap && prDamping == damping && prTolerance == tolerance &&
+        prMaxIterations == maxIterations) return;
+
+    prScores = pageRankOf(*snap, damping, tolerance, maxIterations, &prIterations, &prResidual);
+    prSnap = snap;
+    prDamping = damping;
+    prTolerance = tolerance;
+    prMaxIterations = maxIterations;
+}
+
+std::vector<std::pair<int, double>> GraphAlgorithms::topInfluencers(int topN, double damping,
+                                                                    double tolerance, int maxIterations) {
+    std::vector<std::pair<int, double>> res;
+    if (!G || topN <= 0) return res;
+    if (damping < 0.0 || damping >= 1.0) damping = 0.85;
+    if (maxIterations <= 0) maxIterations = 100;
+    ensurePageRank(damping, tolerance, maxIterations);
+    return topScored(*prSnap, prScores, topN);
+}
+
+std::vector<std::pair<int, double>> GraphAlgorithms::topScored(const CsrGraph &g,
+                                                               const std::vector<double> &scores, int topN) {
+    std::vector<std::pair<int, double>> res;
+    if (topN <= 0) return res;
+    res.reserve(scores.size());
+    for (size_t u = 0; u < scores.size(); ++u) res.push_back({g.idOf((int)u), scores[u]});
+    auto better = [](const std::pair<int, double> &a, const std::pair<int, double> &b) {
+        if (a.second != b.second) return a.second > b.second;
+        return a.first < b.first;
+    };
+    if ((int)res.size() > topN) {
+        std::partial_sort(res.begin(), res.begin() + topN, res.end(), better);
+        res.resize(topN);
+    } else {
+        std::sort(res.begin(), res.end(), better);
+    }
+    return res;
+}
+
+
+// =============================================================
+// 7️⃣ Sampled Betweenness Centrality (Brandes)
+// =============================================================
+namespace {
+// Per-worker Brandes state; arrays are reset only where a BFS touched them.
+struct BrandesScratch {
+    std::vector<int> dist, order, queue;
+    std::vector<double> sigma, delta, sum, sumSq;
+    explicit BrandesScratch(int n)
+        : dist(n, -1), queue(n), sigma(n, 0.0), delta(n, 0.0), sum(n, 0.0), sumSq(n, 0.0) {
+        order.reserve(n);
+    }
+};
+}
+
+static void brandesFrom(const CsrGraph &g, int s, BrandesScratch &st) {
+    st.order.clear();
+    size_t qh = 0, qt = 0;
+    st.dist[s] = 0;
+    st.sigma[s] = 1.0;
+    st.queue[qt++] = s;
+    while (qh < qt) {
+        int v = st.queue[qh++];
+        st.order.push_back(v);
+        for (const int *p = g.begin(v); p != g.end(v); ++p) {
+            int w = *p;
+            if (st.dist[w] < 0) {
+                st.dist[w] = st.dist[v] + 1;
+                st.queue[qt++] = w;
+            }
+            if (st.dist[w] == st.dist[v] + 1) st.sigma[w] += st.sigma[v];
+        }
+    }
+
+    // Dependencies in reverse BFS order
+    for (size_t i = st.order.size(); i-- > 0;) {
+        int w = st.order[i];
+        double coeff = (1.0 + st.delta[w]) / st.sigma[w];
+        for (const int *p = g.begin(w); p != g.end(w); ++p) {
+            int v = *p;
+            if (st.dist[v] == st.dist[w] - 1) st.delta[v] += st.sigma[v] * coeff;
+        }
+        if (w != s) {
+            st.sum[w] += st.delta[w];
+            st.sumSq[w] += st.delta[w] * st.delta[w];
+        }
+    }
+
+    for (int v : st.order) {
+        st.dist[v] = -1;
+        st.sigma[v] = 0.0;
+        st.delta[v] = 0.0;
+    }
+}
+
+std::vector<BridgeScore> GraphAlgorithms::approxBetweenness(int samples, int topN, uint32_t seed) {
+    if (!G) return std::vector<BridgeScore>();
+    return betweennessOf(*G->snapshot(), samples, topN, seed);
+}
+
+std::vector<BridgeScore> GraphAlgorithms::betweennessOf(const CsrGraph &g, int samples, int topN, uint32_t seed,
+                                                        const std::atomic<bool> *cancel) {
+    std::vector<BridgeScore> res;
+    if (topN <= 0 || samples <= 0) return res;
+    int n = g.numNodes();
+    if (n < 3) return res;
+
+    // Distinct sources via a partial Fisher-Yates shuffle
+    int k = samples < n ? samples : n;
+    std::vector<int> sources(n);
+    for (int i = 0; i < n; ++i) sources[i] = i;
+    std::mt19937 rng(seed);
+    for (int i = 0; i < k; ++i) {
+        std::uniform_int_distribution<int> pick(i, n - 1);
+        std::swap(sources[i], sources[pick(rng)]);
+    }
+    sources.resize(k);
+
+    ParallelScope scope;
+    std::vector<std::unique_ptr<BrandesScratch>> scratch(scope.workers());
+    parallelFor(0, k, 1, [&](size_t lo, size_t hi, unsigned worker) {
+        if (!scratch[worker]) scratch[worker].reset(new BrandesScratch(n));
+        for (size_t i = lo; i < hi; ++i) {
+            if (cancel && cancel->load(std::memory_order_relaxed)) return;
+            brandesFrom(g, sources[i], *scratch[worker]);
+        }
+    });
+    if (cancel && cancel->load()) return res;
+
+    // Parallel reduction of the per-worker sums
+    std::vector<double> sum(n, 0.0), sumSq(n, 0.0);
+    parallelFor(0, n, 4096, [&](size_t lo, size_t hi, unsigned) {
+        for (auto &st : scratch) {
+            if (!st) continue;
+            for (size_t v = lo; v < hi; ++v) {
+                sum[v] += st->sum[v];
+                sumSq[v] += st->sumSq[v];
+            }
+        }
+    });
+
+    // Each source s gives an unbiased sample X_s = n * delta_s(v) / 2
+    // (undirected paths are seen from both ends).
+    double scale = (double)n / 2.0;
+    double fpc = (k < n && n > 1) ? std::sqrt((double)(n - k) / (double)(n - 1)) : 0.0;
+    double pairs = (double)(n - 1) * (double)(n - 2) / 2.0;
+    res.reserve(n);
+    for (int v = 0; v < n; ++v) {
+        double mean = sum[v] / k;
+        double err = 0.0;
+        if (k > 1 && fpc > 0.0) {
+            double var = (sumSq[v] - k * mean * mean) / (k - 1);
+            if (var < 0.0) var = 0.0;
+            err = 1.96 * scale * std::sqrt(var / k) * fpc;
+        }
+        double score = mean * scale;
+        res.push_back({g.idOf(v), score, err, score / pairs});
+    }
+
+    auto better = [](const BridgeScore &a, const BridgeScore &b) {
+        if (a.score != b.score) return a.score > b.score;
+        return a.userId < b.userId;
+    };
+    if ((int)res.size() > topN) {
+        std::partial_sort(res.begin(), res.begin() + topN, res.end(), better);
+        res.resize(topN);
+    } else {
+        std::sort(res.begin(), res.end(), better);
+    }
+    return res;
+}
+
+
+// =============================================================
+// 8️⃣ Community Detection (Parallel Louvain)
+// =============================================================
+namespace {
+// Weighted graph for one Louvain level. selfW[u] holds the weight of edges
+// folded inside u by aggregation (counted in both directions).
+struct WeightedGraph {
+    std::vector<size_t> off;
+    std::vector<int> nbr;
+    std::vector<double> w;
+    std::vector<double> selfW;
+    int n() const { return (int)selfW.size(); }
+};
+
+// Per-worker sparse accumulator over community ids.
+struct CommAccumulator {
+    std::vector<double> weight;
+    std::vector<int> touched;
+    explicit CommAccumulator(int n) : weight(n, 0.0) {}
+    void add(int c, double x) {
+        if (weight[c] == 0.0) touched.push_back(c);
+        weight[c] += x;
+    }
+    void reset() {
+        for (int c : touched) weight[c] = 0.0;
+        touched.clear();
+    }
+};
+
+double modularityOf(const WeightedGraph &g, const std::vector<int> &comm,
+                    const std::vector<double> &k, double m2) {
+    if (m2 <= 0.0) return 0.0;
+    int n = g.n();
+    std::vector<double> in(n, 0.0), tot(n, 0.0);
+    for (int u = 0; u < n; ++u) {
+        tot[comm[u]] += k[u];
+        double inside = g.selfW[u];
+        for (size_t e = g.off[u]; e < g.off[u + 1]; ++e)
+            if (comm[g.nbr[e]] == comm[u]) inside += g.w[e];
+        in[comm[u]] += inside;
+    }
+    double q = 0.0;
+    for (int c = 0; c < n; ++c) q += in[c] / m2 - (tot[c] / m2) * (tot[c] / m2);
+    return q;
+}
+
+// One level of local moving. Returns the partition found (community ids
+// are node ids of g; a community keeps the id of one of its members).
+std::vector<int> louvainLevel(const WeightedGraph &g, const std::vector<double> &k, double m2,
+                              const std::atomic<bool> *cancel) {
+    int n = g.n();
+    std::vector<int> comm(n), next(n), size(n, 1);
+    std::vector<double> tot(k);
+    for (int u = 0; u < n; ++u) comm[u] = u;
+    double q = modularityOf(g, comm, k, m2);
+
+    ParallelScope scope;
+    std::vector<std::unique_ptr<CommAccumulator>> acc(scope.workers());
+    const int kMaxRounds = 32;
+    for (int round = 0; round < kMaxRounds; ++round) {
+        if (cancel && cancel->load(std::memory_order_relaxed)) break;
+        std::atomic<size_t> moved(0);
+        parallelFor(0, n, 512, [&](size_t lo, size_t hi, unsigned worker) {
+            if (!acc[worker]) acc[worker].reset(new CommAccumulator(n));
+            CommAccumulator &a = *acc[worker];
+            size_t localMoves = 0;
+            for (size_t uu = lo; uu < hi; ++uu) {
+                int u = (int)uu;
+                int own = comm[u];
+                next[u] = own;
+                if (g.off[u] == g.off[u + 1]) continue;
+
+                for (size_t e = g.off[u]; e < g.off[u + 1]; ++e) a.add(comm[g.nbr[e]], g.w[e]);
+
+                // Gain of joining c (up to a constant factor): k_u,c - tot_c * k_u / m2,
+                // where u itself is taken out of its own community first.
+                double ownTot = tot[own] - k[u];
+                double bestGain = a.weight[own] - ownTot * k[u] / m2;
+                int best = own;
+                for (int c : a.touched) {
+                    if (c == own) continue;
+                    double gain = a.weight[c] - tot[c] * k[u] / m2;
+                    if (gain > bestGain + 1e-12 || (std::fabs(gain - bestGain) <= 1e-12 && c < best)) {
+                        bestGain = gain;
+                        best = c;
+                    }
+                }
+                a.reset();
+
+                // Two singletons moving into each other's community in the same
+                // round would just swap; only the move toward the lower id is allowed.
+                if (best != own && size[own] == 1 && size[best] == 1 && best > own) best = own;
+                if (best != own) {
+                    next[u] = best;
+                    ++localMoves;
+                }
+            }
+            moved.fetch_add(localMoves, std::memory_order_relaxed);
+        });
+        if (moved.load() == 0) break;
+
+        double nq = modularityOf(g, next, k, m2);
+        if (nq <= q + 1e-9) break; // the synchronous round did not help: keep the old partition
+        comm.swap(next);
+        q = nq;
+        std::fill(tot.begin(), tot.end(), 0.0);
+        std::fill(size.begin(), size.end(), 0);
+        for (int u = 0; u < n; ++u) {
+            tot[comm[u]] += k[u];
+            size[comm[u]]++;
+        }
+    }
+    return comm;
+}
+
+// Collapses each community into one node. @p dense maps community ids to 0..C-1.
+WeightedGraph aggregate(const WeightedGraph &g, const std::vector<int> &comm,
+                        const std::vector<int> &dense, int numComms) {
+    std::vector<std::vector<int>> members(numComms);
+    for (int u = 0; u < g.n(); ++u) members[dense[comm[u]]].push_back(u);
+
+    WeightedGraph out;
+    out.selfW.assign(numComms, 0.0);
+    std::vector<std::vector<std::pair<int, double>>> rows(numComms);
+    ParallelScope scope;
+    std::vector<std::unique_ptr<CommAccumulator>> acc(scope.workers());
+    parallelFor(0, numComms, 64, [&](size_t lo, size_t hi, unsigned worker) {
+        if (!acc[worker]) acc[worker].reset(new CommAccumulator(numComms));
+        CommAccumulator &a = *acc[worker];
+        for (size_t c = lo; c < hi; ++c) {
+            double self = 0.0;
+            for (int u : members[c]) {
+                self += g.selfW[u];
+                for (size_t e = g.off[u]; e < g.off[u + 1]; ++e) {
+                    int d = dense[comm[g.nbr[e]]];
+                    if (d == (int)c) self += g.w[e];
+                    else a.add(d, g.w[e]);
+                }
+            }
+            out.selfW[c] = self;
+            std::sort(a.touched.begin(), a.touched.end());
+            for (int d : a.touched) rows[c].push_back({d, a.weight[d]});
+            a.reset();
+        }
+    });
+
+    out.off.assign(numComms + 1, 0);
+    for (int c = 0; c < numComms; ++c) out.off[c + 1] = out.off[c] + rows[c].size();
+    out.nbr.resize(out.off[numComms]);
+    out.w.resize(out.off[numComms]);
+    for (int c = 0; c < numComms; ++c) {
+        size_t e = out.off[c];
+        for (auto &p : rows[c]) {
+            out.nbr[e] = p.first;
+            out.w[e] = p.second;
+            ++e;
+        }
+    }
+    return out;
+}
+}
+
+const CommunityResult &GraphAlgorithms::detectCommunities() {
+    static const CommunityResult none{{}, 0.0, 0};
+    if (!G) return none;
+    auto snap = G->snapshot();
+    if (commSnap == snap) return commResult;
+    commResult = communitiesOf(*snap, &commOfNode);
+    commSnap = snap;
+    return commResult;
+}
+
+CommunityResult GraphAlgorithms::communitiesOf(const CsrGraph &cg, std::vector<int> *nodeCommunity,
+                                               const std::atomic<bool> *cancel) {
+    CommunityResult res{{}, 0.0, 0};
+    int n = cg.numNodes();
+
+    // Level 0: the friendship graph with unit weights
+    WeightedGraph g0;
+    g0.off.assign(n + 1, 0);
+    for (int u = 0; u < n; ++u) g0.off[u + 1] = g0.off[u] + cg.degree(u);
+    if (n > 0) g0.nbr.assign(cg.begin(0), cg.end(n - 1));
+    g0.w.assign(g0.off[n], 1.0);
+    g0.selfW.assign(n, 0.0);
+    WeightedGraph g = g0;
+
+    std::vector<int> nodeComm(n); // original node -> current aggregated node
+    for (int u = 0; u < n; ++u) nodeComm[u] = u;
+
+    int levels = 0;
+    double m2 = (double)g0.off[n];
+    while (g.n() > 0) {
+        if (cancel && cancel->load(std::memory_order_relaxed)) break;
+        std::vector<double> k(g.n());
+        for (int u = 0; u < g.n(); ++u) {
+            double s = g.selfW[u];
+            for (size_t e = g.off[u]; e < g.off[u + 1]; ++e) s += g.w[e];
+            k[u] = s;
+        }
+        std::vector<int> comm = m2 > 0.0 ? louvainLevel(g, k, m2, cancel) : std::vector<int>();
+        if (comm.empty()) break;
+
+        std::vector<int> dense(g.n(), -1);
+        int numComms = 0;
+        for (int u = 0; u < g.n(); ++u)
+            if (dense[comm[u]] < 0) dense[comm[u]] = numComms++;
+        if (numComms == g.n()) break; // nothing merged: converged
+
+        for (int u = 0; u < n; ++u) nodeComm[u] = dense[comm[nodeComm[u]]];
+        g = aggregate(g, comm, dense, numComms);
+        ++levels;
+    }
+
+    std::vector<double> k0(n);
+    for (int u = 0; u < n; ++u) k0[u] = cg.degree(u);
+
+    int numComms = 0;
+    for (int u = 0; u < n; ++u) numComms = std::max(numComms, nodeComm[u] + 1);
+    std::vector<std::vector<int>> comms(numComms);
+    for (int u = 0; u < n; ++u) comms[nodeComm[u]].push_back(cg.idOf(u));
+
+    // Largest first; ties by smallest member. Members are already ascending.
+    std::vector<int> order(numComms);
+    for (int c = 0; c < numComms; ++c) order[c] = c;
+    std::sort(order.begin(), order.end(), [&](int a, int b) {
+        if (comms[a].size() != comms[b].size()) return comms[a].size() > comms[b].size();
+        return comms[a].front() < comms[b].front();
+    });
+    std::vector<int> rank(numComms);
+    for (int i = 0; i < numComms; ++i) {
+        rank[order[i]] = i;
+        res.communities.push_back(std::move(comms[order[i]]));
+    }
+    res.modularity = modularityOf(g0, nodeComm, k0, m2);
+    res.levels = levels;
+    if (nodeCommunity) {
+        nodeCommunity->resize(n);
+        for (int u = 0; u < n; ++u) (*nodeCommunity)[u] = rank[nodeComm[u]];
+    }
+    return res;
+}
+
+int GraphAlgorithms::communityOf(int userId) {
+    if (!G || !G->userExists(userId)) return -1;
+    detectCommunities();
+    int u = commSnap->indexOf(userId);
+    return u < 0 ? -1 : commOfNode[u];
+}
+
+
+// =============================================================
+// 9️⃣ k-Core Decomposition
+// =============================================================
+namespace {
+// Batagelj-Zaversnik: bucket vertices by degree and peel in increasing
+// order, moving each affected neighbor down one bucket in O(1).
+std::vector<int> bucketCores(const CsrGraph &g) {
+    int n = g.numNodes();
+    std::vector<int> deg(n), pos(n), vert(n);
+    int maxDeg = 0;
+    for (int u = 0; u < n; ++u) {
+        deg[u] = (int)g.degree(u);
+        maxDeg = std::max(maxDeg, deg[u]);
+    }
+    std::vector<int> bin(maxDeg + 2, 0);
+    for (int u = 0; u < n; ++u) bin[deg[u]]++;
+    int start = 0;
+    for (int d = 0; d <= maxDeg; ++d) {
+        int cnt = bin[d];
+        bin[d] = start;
+        start += cnt;
+    }
+    for (int u = 0; u < n; ++u) {
+        pos[u] = bin[deg[u]]++;
+        vert[pos[u]] = u;
+    }
+    for (int d = maxDeg; d > 0; --d) bin[d] = bin[d - 1];
+    bin[0] = 0;
+
+    for (int i = 0; i < n; ++i) {
+        int v = vert[i];
+        for (const int *p = g.begin(v); p != g.end(v); ++p) {
+            int u = *p;
+            if (deg[u] > deg[v]) {
+                // swap u with the first vertex of its bucket, then shrink the bucket
+                int du = deg[u], pu = pos[u];
+                int pw = bin[du], w = vert[pw];
+                if (u != w) {
+                    pos[u] = pw; vert[pw] = u;
+                    pos[w] = pu; vert[pu] = w;
+                }
+                bin[du]++;
+                deg[u]--;
+            }
+        }
+    }
+    return deg;
+}
+
+// Level-synchronous peeling: at level k, every remaining vertex with
+// degree k is removed in parallel; neighbors whose degree drops to k join
+// the next sub-round. Degrees never go below k, so each vertex is
+// discovered exactly once.
+std::vector<int> parallelPeelCores(const CsrGraph &g) {
+    int n = g.numNodes();
+    std::unique_ptr<std::atomic<int>[]> deg(new std::atomic<int>[n]);
+    std::vector<int> core(n, -1);
+    for (int u = 0; u < n; ++u) deg[u].store((int)g.degree(u), std::memory_order_relaxed);
+
+    ParallelScope scope;
+    unsigned workers = scope.workers();
+    std::vector<std::vector<int>> found(workers);
+    std::vector<int> frontier;
+    int remaining = n;
+    for (int k = 0; remaining > 0; ++k) {
+        parallelFor(0, n, 4096, [&](size_t lo, size_t hi, unsigned worker) {
+            for (size_t u = lo; u < hi; ++u)
+                if (core[u] < 0 && deg[u].load(std::memory_order_relaxed) <= k) found[worker].push_back((int)u);
+        });
+        frontier.clear();
+        for (auto &f : found) {
+            frontier.insert(frontier.end(), f.begin(), f.end());
+            f.clear();
+        }
+
+        while (!frontier.empty()) {
+            for (int u : frontier) core[u] = k;
+            remaining -= (int)frontier.size();
+            parallelFor(0, frontier.size(), 64, [&](size_t lo, size_t hi, unsigned worker) {
+                for (size_t i = lo; i < hi; ++i) {
+                    int u = frontier[i];
+                    for (const int *p = g.begin(u); p != g.end(u); ++p) {
+                        int w = *p;
+                        if (core[w] >= 0) continue;
+                        int d = deg[w].load(std::memory_order_relaxed);
+                        while (d > k && !deg[w].compare_exchange_weak(d, d - 1, std::memory_order_relaxed)) {}
+                        if (d == k + 1) found[worker].push_back(w);
+                    }
+                }
+            });
+            frontier.clear();
+            for (auto &f : found) {
+                frontier.insert(frontier.end(), f.begin(), f.end());
+                f.clear();
+            }
+        }
+    }
+    return core;
+}
+}
+
+std::vector<int> GraphAlgorithms::coreNumbersOf(const CsrGraph &g) {
+    const int kParallelMinNodes = 1 << 16;
+    if (g.numNodes() >= kParallelMinNodes && parallelWorkers() > 1) return parallelPeelCores(g);
+    return bucketCores(g);
+}
+
+void GraphAlgorithms::recomputeCores() {
+    coreNum.clear();
+    coreMax = 0;
+    coreValid = false;
+    if (!G) return;
+    auto snap = G->snapshot();
+    const CsrGraph &g = *snap;
+    std::vector<int> core = coreNumbersOf(g);
+    coreNum.reserve(g.numNodes());
+    for (int u = 0; u < g.numNodes(); ++u) {
+        coreNum[g.idOf(u)] = core[u];
+        coreMax = std::max(coreMax, core[u]);
+    }
+    coreVer = snap->version();
+    coreValid = true;
+}
+
+void GraphAlgorithms::ensureCores() {
+    if (!G) return;
+    if (!coreValid || coreVer != G->version()) recomputeCores();
+}
+
+int GraphAlgorithms::coreNumber(int userId) {
+    if (!G || !G->userExists(userId)) return -1;
+    ensureCores();
+    auto it = coreNum.find(userId);
+    return it == coreNum.end() ? -1 : it->second;
+}
+
+std::vector<int> GraphAlgorithms::kCore(int k) {
+    std::vector<int> members;
+    if (!G) return members;
+    ensureCores();
+    for (auto &kv : coreNum)
+        if (kv.second >= k) members.push_back(kv.first);
+    std::sort(members.begin(), members.end());
+    return members;
+}
+
+int GraphAlgorithms::maxCoreNumber() {
+    if (!G) return 0;
+    ensureCores();
+    return coreMax;
+}
+
+// True when the cores were valid right before the single mutation being reported.
+bool GraphAlgorithms::coresTrackOneChange() const {
+    return G && coreValid && coreVer + 1 == G->version();
+}
+
+void GraphAlgorithms::onUserAdded(int userId) {
+    if (!coresTrackOneChange()) {
+        coreValid = false;
+        return;
+    }
+    coreNum[userId] = 0;
+    coreVer = G->version();
+}
+
+void GraphAlgorithms::onFriendAdded(int a, int b) {
+    if (!coresTrackOneChange()) {
+        coreValid = false;
+        return;
+    }
+    repeelSubcore(a, b, true);
+}
+
+void GraphAlgorithms::onFriendRemoved(int a, int b) {
+    if (!coresTrackOneChange()) {
+        coreValid = false;
+        return;
+    }
+    repeelSubcore(a, b, false);
+}
+
+// Only users whose core number equals K = min(core(a), core(b)) and that are
+// reachable from a or b through such users can change, and only by one.
+// Collect that subcore, count each member's friends that could support
+// the new level, and peel members that fall short.
+void GraphAlgorithms::repeelSubcore(int a, int b, bool inserted) {
+    auto ca = coreNum.find(a), cb = coreNum.find(b);
+    if (ca == coreNum.end() || cb == coreNum.end()) {
+        coreValid = false;
+        return;
+    }
+    int K = std::min(ca->second, cb->second);
+
+    std::unordered_map<int, int> support; // subcore member -> supporting friends
+    std::vector<int> order;
+    std::vector<int> roots;
+    if (ca->second == K) roots.push_back(a);
+    if (cb->second == K) roots.push_back(b);
+    for (int r : roots) {
+        if (support.count(r)) continue;
+        support[r] = 0;
+        order.push_back(r);
+    }
+    for (size_t i = 0; i < order.size(); ++i) {
+        for (int w : G->neighbors(order[i])) {
+            if (coreNum[w] != K || support.count(w)) continue;
+            support[w] = 0;
+            order.push_back(w);
+        }
+    }
+
+    // Insertion: can a member reach K + 1? It needs K + 1 friends with core >= K
+    // that survive. Deletion: can it stay at K? It needs K such friends.
+    int need = inserted ? K + 1 : K;
+    std::vector<int> stack;
+    for (int u : order) {
+        int s = 0;
+        for (int w : G->neighbors(u))
+            if (coreNum[w] >= K) ++s;
+        support[u] = s;
+        if (s < need) stack.push_back(u);
+    }
+
+    std::unordered_set<int> peeled;
+    while (!stack.empty()) {
+        int u = stack.back();
+        stack.pop_back();
+        if (!peeled.insert(u).second) continue;
+        for (int w : G->neighbors(u)) {
+            auto it = support.find(w);
+            if (it == support.end() || peeled.count(w)) continue;
+            if (--it->second < need) stack.push_back(w);
+        }
+    }
+
+    for (int u : order) {
+        bool survives = !peeled.count(u);
+        if (inserted && survives) coreNum[u] = K + 1;
+        if (!inserted && !survives) coreNum[u] = K - 1;
+    }
+    if (inserted) {
+        for (int u : order)
+            if (coreNum[u] > coreMax) coreMax = coreNum[u];
+    } else if (K == coreMax) {
+        coreMax = 0;
+        for (auto &kv : coreNum) coreMax = std::max(coreMax, kv.second);
+    }
+    coreVer = G->version();
 }
\ No newline at end of file
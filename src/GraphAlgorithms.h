@@ -2,9 +2,47 @@
 #define GRAPH_ALGORITHMS_H
 
 #include <vector>
+#include <memory>
+#include <atomic>
+#include <utility>
+#include <cstdint>
+#include <unordered_map>
 
 // Forward declaration to avoid circular include
 class CoreGraph;
+class CsrGraph;
+class CompressedCsr;
+
+/**
+ * @brief Network-wide triangle summary.
+ */
+struct TriangleStats {
+    uint64_t triangles;   ///< Exact count, or the estimate in sampling mode
+    uint64_t wedges;      ///< Connected triples (paths of length two)
+    double transitivity;  ///< 3 * triangles / wedges (global clustering coefficient)
+    bool exact;           ///< false when estimated by wedge sampling
+    uint64_t samples;     ///< Wedges sampled (0 when exact)
+    double stdError;      ///< Standard error of the transitivity estimate (0 when exact)
+};
+
+/**
+ * @brief Approximate betweenness of one user.
+ */
+struct BridgeScore {
+    int userId;
+    double score;      ///< Estimated number of shortest paths through the user
+    double error;      ///< 95% confidence half-width of score (0 when all sources were used)
+    double normalized; ///< score / ((n-1)(n-2)/2), in [0, 1]
+};
+
+/**
+ * @brief Modularity-based partition of the network.
+ */
+struct CommunityResult {
+    std::vector<std::vector<int>> communities; ///< Largest first; members ascending
+    double modularity;                         ///< Newman-Girvan modularity of the partition
+    int levels;                                ///< Louvain aggregation levels performed
+};
 
 /**
  * @brief The GraphAlgorithms class implements
@@ -20,12 +58,19 @@ public:
 
     /**
      * @brief Finds the shortest path between two users (unweighted).
+     * In compressed snapshot mode the BFS runs on the compressed snapshot.
      * @param src Source user ID
      * @param dst Destination user ID
      * @return List of user IDs representing the path
      */
     std::vector<int> shortestPath(int src, int dst);
 
+    /**
+     * @brief Number of friends two users have in common, from the
+     * compressed snapshot in compressed snapshot mode.
+     */
+    size_t mutualCount(int a, int b);
+
     /**
      * @brief Finds all connected components (communities) in the network.
      * @return A vector of components (each component is a vector of user IDs)
@@ -44,8 +89,209 @@ public:
      */
     int influencerByInterestOverlap();
 
+    // ----------------------------
+    // Triangles & Clustering
+    // ----------------------------
+
+    /**
+     * @brief Counts all triangles exactly (parallel, degree-ordered orientation).
+     * Results are cached until the graph changes.
+     */
+    TriangleStats triangleStats();
+
+    /**
+     * @brief Estimates triangles and transitivity by uniform wedge sampling.
+     * @param samples Number of wedges to sample
+     * @param seed Random seed (same seed and graph give the same estimate)
+     */
+    TriangleStats approxTriangleStats(uint64_t samples, uint32_t seed = 42);
+
+    /**
+     * @brief Number of triangles a user belongs to.
+     * @return Triangle count, or -1 if the user does not exist
+     */
+    long long trianglesOf(int userId);
+
+    /**
+     * @brief Local clustering coefficient: closed fraction of the user's friend pairs.
+     * @return Coefficient in [0, 1] (0 for degree < 2), or -1 if the user does not exist
+     */
+    double localClustering(int userId);
+
+    /**
+     * @brief Users with the highest local clustering, e.g. to spot cliques and bot rings.
+     * @param topN Number of users to return
+     * @param minDegree Ignore users with fewer friends (small degrees saturate at 1.0)
+     * @return (userId, coefficient) pairs, highest first
+     */
+    std::vector<std::pair<int, double>> mostClustered(int topN, int minDegree);
+
+    // ----------------------------
+    // PageRank
+    // ----------------------------
+
+    /**
+     * @brief Ranks users by PageRank instead of raw friend count.
+     *
+     * Pull-based power iteration over the CSR snapshot, parallel over users.
+     * Dangling users (no friends) spread their rank uniformly. Scores are
+     * cached until the graph changes or different parameters are requested.
+     *
+     * @param topN Number of users to return
+     * @param damping Probability of following an edge (usually 0.85)
+     * @param tolerance Stop when the L1 change between iterations drops below this
+     * @param maxIterations Hard cap on iterations
+     * @return (userId, score) pairs, highest first; scores sum to 1 over all users
+     */
+    std::vector<std::pair<int, double>> topInfluencers(int topN, double damping = 0.85,
+                                                       double tolerance = 1e-6, int maxIterations = 100);
+
+    /**
+     * @brief Iterations used and final L1 residual of the cached PageRank run.
+     */
+    int pageRankIterations() const { return prIterations; }
+    double pageRankResidual() const { return prResidual; }
+
+    // ----------------------------
+    // Betweenness (bridges)
+    // ----------------------------
+
+    /**
+     * @brief Finds "bridge" users with sampled Brandes betweenness centrality.
+     *
+     * Runs one BFS + dependency accumulation per sampled source, in parallel
+     * with per-worker arrays, then reduces and scales by n / samples. The
+     * error bound comes from the per-source variance of each user's
+     * dependency (normal approximation with finite-population correction).
+     *
+     * @param samples Number of source users (>= n means exact)
+     * @param topN Number of users to return
+     * @param seed Random seed for source selection
+     * @return Users with the highest estimated betweenness, highest first
+     */
+    std::vector<BridgeScore> approxBetweenness(int samples, int topN, uint32_t seed = 42);
+
+    // ----------------------------
+    // Community detection
+    // ----------------------------
+
+    /**
+     * @brief Splits the network into densely connected communities (parallel Louvain).
+     *
+     * Unlike connectedComponents(), this separates clusters inside one giant
+     * component. Each level moves every user to the neighboring community
+     * with the best modularity gain (decided in parallel from the previous
+     * round's assignment), then collapses communities into weighted nodes.
+     * The result is cached until the graph changes.
+     */
+    const CommunityResult &detectCommunities();
+
+    /**
+     * @brief Index into detectCommunities().communities for a user, or -1.
+     */
+    int communityOf(int userId);
+
+    // ----------------------------
+    // k-core decomposition
+    // ----------------------------
+
+    /**
+     * @brief Core number of a user: the largest k such that the user belongs
+     * to a subgraph where everyone has at least k friends. -1 if missing.
+     */
+    int coreNumber(int userId);
+
+    /**
+     * @brief Members of the k-core (users with core number >= k), ascending.
+     */
+    std::vector<int> kCore(int k);
+
+    /**
+     * @brief Largest core number in the network (degeneracy).
+     */
+    int maxCoreNumber();
+
+    /**
+     * @brief Recomputes all core numbers from scratch.
+     *
+     * Uses linear-time bucket peeling (Batagelj-Zaversnik), or level-synchronous
+     * parallel peeling when the graph is large and several workers are available.
+     */
+    void recomputeCores();
+
+    /**
+     * @brief Incremental maintenance hooks; call right after the matching
+     * CoreGraph mutation succeeded. Only the subcore around the changed edge
+     * is re-peeled. If the graph changed in any other way since the cores were
+     * last valid, the next query falls back to a full recomputation.
+     */
+    void onUserAdded(int userId);
+    void onFriendAdded(int a, int b);
+    void onFriendRemoved(int a, int b);
+
+    // ----------------------------
+    // Snapshot kernels
+    // ----------------------------
+    // Pure functions of an immutable CSR snapshot: they read neither the
+    // live graph nor any cache, so background jobs may run them on any
+    // thread. The member functions above are cached wrappers around them.
+    // PageRank, betweenness and communities also take an optional cancel
+    // flag, checked once per iteration / source / Louvain round; when it
+    // is set they stop early and return a partial (or empty) result.
+    // The CompressedCsr overloads decode rows on the fly and serve
+    // compressed snapshot mode (CoreGraph::setCompressedSnapshots).
+
+    static std::vector<std::vector<int>> componentsOf(const CsrGraph &g);
+    static std::vector<std::vector<int>> componentsOf(const CompressedCsr &g);
+    static std::vector<int> shortestPathOf(const CompressedCsr &g, int src, int dst);  // User ids; empty if unreachable
+    static size_t mutualCountOf(const CompressedCsr &g, int a, int b);
+    static TriangleStats triangleStatsOf(const CsrGraph &g, std::vector<uint64_t> *perNode = nullptr);
+    static std::vector<double> pageRankOf(const CsrGraph &g, double damping, double tolerance,
+                                          int maxIterations, int *iterations = nullptr,
+                                          double *residual = nullptr,
+                                          const std::atomic<bool> *cancel = nullptr);
+    static std::vector<BridgeScore> betweennessOf(const CsrGraph &g, int samples, int topN, uint32_t seed,
+                                                  const std::atomic<bool> *cancel = nullptr);
+    static CommunityResult communitiesOf(const CsrGraph &g, std::vector<int> *nodeCommunity = nullptr,
+                                         const std::atomic<bool> *cancel = nullptr);
+    static std::vector<int> coreNumbersOf(const CsrGraph &g);
+
+    /**
+     * @brief Top @p topN (userId, score) pairs from per-index scores, highest first.
+     */
+    static std::vector<std::pair<int, double>> topScored(const CsrGraph &g,
+                                                         const std::vector<double> &scores, int topN);
+
 private:
     CoreGraph *G;  // Pointer to the main graph structure
+
+    // Exact triangle results for the snapshot they were computed on
+    std::shared_ptr<const CsrGraph> triSnap;
+    std::vector<uint64_t> triPerNode;
+    TriangleStats triTotals;
+    void ensureTriangles();
+
+    // Cached PageRank scores (indexed like prSnap) and the parameters used
+    std::shared_ptr<const CsrGraph> prSnap;
+    std::vector<double> prScores;
+    double prDamping, prTolerance;
+    int prMaxIterations, prIterations;
+    double prResidual;
+    void ensurePageRank(double damping, double tolerance, int maxIterations);
+
+    // Cached community partition and the dense-index -> community map
+    std::shared_ptr<const CsrGraph> commSnap;
+    CommunityResult commResult;
+    std::vector<int> commOfNode;
+
+    // Core numbers by user id, valid while coreVer matches the graph version
+    std::unordered_map<int, int> coreNum;
+    uint64_t coreVer;
+    bool coreValid;
+    int coreMax;
+    void ensureCores();
+    bool coresTrackOneChange() const;
+    void repeelSubcore(int a, int b, bool inserted);
 };
 
 #endif // GRAPH_ALGORITHMS_H
\ No newline at end of file
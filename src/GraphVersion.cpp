@@ -0,0 +1,16 @@
+#include "GraphVersion.h"
+#include "MemoryReport.h"
+
+size_t GraphVersion::memoryBytes() const {
+    size_t bytes = MemoryReport::vectorBytes(pages) + MemoryReport::vectorBytes(*order);
+    for (auto &page : pages) {
+        bytes += MemoryReport::vectorBytes(*page);
+        for (auto &row : *page) {
+            if (!row) continue;
+            bytes += MemoryReport::heapBlock(sizeof(Row)) + MemoryReport::stringBytes(row->name) +
+                     MemoryReport::vectorBytes(row->interests) + MemoryReport::vectorBytes(row->friends);
+            for (auto &i : row->interests) bytes += MemoryReport::stringBytes(i);
+        }
+    }
+    return bytes;
+}
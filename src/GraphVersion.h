@@ -0,0 +1,61 @@
+#ifndef GRAPH_VERSION_H
+#define GRAPH_VERSION_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+
+class CoreGraph;
+
+/**
+ * @class GraphVersion
+ * @brief Immutable point-in-time image of the whole graph: users, names,
+ * interests and friend lists.
+ *
+ * Obtained from CoreGraph::pin(). Each user is one immutable row, and rows
+ * are grouped into fixed pages by the user's dense index. Publishing the
+ * next version copies only the page table, the pages holding changed users
+ * and those users' rows; every other page is shared with the previous
+ * version. A version lives as long as someone holds it, so a reader that
+ * pinned one keeps a consistent image while writers move on, and old
+ * versions are freed when their last reader lets go.
+ */
+class GraphVersion {
+public:
+    struct Row {
+        int id;
+        std::string name;
+        std::vector<std::string> interests;
+        std::vector<int> friends;                     ///< Sorted
+    };
+
+    uint64_t version() const { return ver; }          ///< CoreGraph::version() when published
+    uint64_t stamp() const { return clock; }          ///< CoreGraph::modClock() when published
+    size_t size() const { return order->size(); }     ///< Number of users
+
+    /**
+     * @brief The i-th user in ascending id order, 0 <= i < size().
+     */
+    const Row &row(size_t i) const {
+        uint32_t slot = (*order)[i];
+        return *(*pages[slot / kPageRows])[slot % kPageRows];
+    }
+
+    size_t memoryBytes() const;   ///< Bytes reachable from this version (shared pages included)
+
+private:
+    friend class CoreGraph;
+    static const size_t kPageRows = 256;
+    using Page = std::vector<std::shared_ptr<const Row>>;  // kPageRows rows, nullptr for empty slots
+
+    GraphVersion() : ver(0), clock(0) {}
+
+    uint64_t ver;
+    uint64_t clock;
+    std::vector<std::shared_ptr<const Page>> pages;        // by dense index / kPageRows
+    std::shared_ptr<const std::vector<uint32_t>> order;    // dense indices in ascending id order
+};
+
+#endif // GRAPH_VERSION_H
@@ -0,0 +1,89 @@
+#include "InterestIndex.h"
+#include "MemoryReport.h"
+#include <algorithm>
+
+// =============================================================
+// 1️⃣ Maintenance
+// =============================================================
+void InterestIndex::addUser(int userId) {
+    everyone.add((uint32_t)userId);
+}
+
+void InterestIndex::removeUser(int userId, const std::unordered_set<std::string> &interests) {
+    everyone.remove((uint32_t)userId);
+    for (auto &i : interests) {
+        auto it = lists.find(i);
+        if (it == lists.end()) continue;
+        it->second.remove((uint32_t)userId);
+        if (it->second.empty()) lists.erase(it);
+    }
+}
+
+void InterestIndex::add(const std::string &interest, int userId) {
+    lists[interest].add((uint32_t)userId);
+}
+
+void InterestIndex::clear() {
+    lists.clear();
+    everyone.clear();
+}
+
+
+// =============================================================
+// 2️⃣ Queries
+// =============================================================
+const RoaringBitmap *InterestIndex::postings(const std::string &interest) const {
+    auto it = lists.find(interest);
+    return it == lists.end() ? nullptr : &it->second;
+}
+
+RoaringBitmap InterestIndex::search(const InterestQuery &query) const {
+    // Step 1: AND terms, smallest posting list first
+    std::vector<const RoaringBitmap*> required;
+    for (auto &i : query.all) {
+        const RoaringBitmap *p = postings(i);
+        if (!p) return RoaringBitmap();
+        required.push_back(p);
+    }
+    std::sort(required.begin(), required.end(), [](const RoaringBitmap *a, const RoaringBitmap *b) {
+        return a->cardinality() < b->cardinality();
+    });
+
+    // Step 2: OR terms
+    RoaringBitmap anyOf;
+    for (auto &i : query.any) {
+        const RoaringBitmap *p = postings(i);
+        if (p) anyOf = RoaringBitmap::orOf(anyOf, *p);
+    }
+    if (!query.any.empty() && anyOf.empty()) return RoaringBitmap();
+
+    RoaringBitmap result;
+    if (!required.empty()) {
+        result = *required[0];
+        for (size_t k = 1; k < required.size() && !result.empty(); ++k)
+            result = RoaringBitmap::andOf(result, *required[k]);
+        if (!query.any.empty()) result = RoaringBitmap::andOf(result, anyOf);
+    } else if (!query.any.empty()) {
+        result = std::move(anyOf);
+    } else {
+        result = everyone;
+    }
+
+    // Step 3: NOT terms
+    for (auto &i : query.none) {
+        if (result.empty()) break;
+        const RoaringBitmap *p = postings(i);
+        if (p) result = RoaringBitmap::andNotOf(result, *p);
+    }
+    return result;
+}
+
+void InterestIndex::reportMemory(MemoryReport &report) const {
+    size_t bytes = MemoryReport::tableBytes(lists) + everyone.memoryBytes();
+    size_t entries = 0;
+    for (auto &p : lists) {
+        bytes += MemoryReport::stringBytes(p.first) + p.second.memoryBytes();
+        entries += p.second.cardinality();
+    }
+    report.add("graph.interest_index", bytes, entries);
+}
@@ -0,0 +1,58 @@
+#ifndef INTEREST_INDEX_H
+#define INTEREST_INDEX_H
+
+#include "RoaringBitmap.h"
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+
+class MemoryReport;
+
+/**
+ * @brief A boolean interest query: users having every interest in
+ * @c all, at least one in @c any (if non-empty) and none in @c none.
+ */
+struct InterestQuery {
+    std::vector<std::string> all;
+    std::vector<std::string> any;
+    std::vector<std::string> none;
+};
+
+/**
+ * @class InterestIndex
+ * @brief Inverted index from interest to the users who have it.
+ *
+ * Each posting list is a RoaringBitmap of user ids, so queries combine
+ * whole lists instead of scanning every user's interest set. CoreGraph
+ * keeps it in sync with users and interests; interests are stored as
+ * given (CoreGraph lowercases them first).
+ */
+class InterestIndex {
+public:
+    void addUser(int userId);
+    void removeUser(int userId, const std::unordered_set<std::string> &interests);
+    void add(const std::string &interest, int userId);
+    void clear();
+
+    /**
+     * @brief Users having @p interest (nullptr if nobody has it).
+     */
+    const RoaringBitmap *postings(const std::string &interest) const;
+
+    /**
+     * @brief Evaluates @p query. AND terms are applied smallest list
+     * first and stop early once the result is empty; a query without
+     * AND or OR terms starts from all users.
+     */
+    RoaringBitmap search(const InterestQuery &query) const;
+
+    size_t interestCount() const { return lists.size(); }
+    void reportMemory(MemoryReport &report) const; // Bytes held by the posting lists
+
+private:
+    std::unordered_map<std::string, RoaringBitmap> lists;
+    RoaringBitmap everyone;
+};
+
+#endif // INTEREST_INDEX_H
@@ -0,0 +1,224 @@
+#include "JobManager.h"
+#include "CsrGraph.h"
+#include <cstdlib>
+#include <exception>
+
+// =============================================================
+// 1️⃣ Parameters
+// =============================================================
+int JobContext::intParam(const std::string &key, int fallback) const {
+    auto it = params.find(key);
+    if (it == params.end() || it->second.empty()) return fallback;
+    char *end = nullptr;
+    long v = std::strtol(it->second.c_str(), &end, 10);
+    return (end && *end == '\0') ? (int)v : fallback;
+}
+
+double JobContext::doubleParam(const std::string &key, double fallback) const {
+    auto it = params.find(key);
+    if (it == params.end() || it->second.empty()) return fallback;
+    char *end = nullptr;
+    double v = std::strtod(it->second.c_str(), &end);
+    return (end && *end == '\0') ? v : fallback;
+}
+
+std::unordered_map<std::string, std::string> JobManager::parseParams(const std::string &params) {
+    std::unordered_map<std::string, std::string> out;
+    size_t start = 0;
+    while (start <= params.size()) {
+        size_t stop = params.find_first_of("&,", start);
+        if (stop == std::string::npos) stop = params.size();
+        std::string item = params.substr(start, stop - start);
+        size_t eq = item.find('=');
+        if (!item.empty()) {
+            if (eq == std::string::npos) out[item] = "";
+            else out[item.substr(0, eq)] = item.substr(eq + 1);
+        }
+        start = stop + 1;
+    }
+    return out;
+}
+
+
+// =============================================================
+// 2️⃣ Submission & Queries
+// =============================================================
+JobManager::JobManager() : nextId(1), stopping(false) {}
+
+JobManager::~JobManager() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+        for (auto &job : queue) job->cancelRequested.store(true);
+        // A running job would otherwise hold up the join until it finishes
+        for (auto &entry : jobs)
+            if (entry.second->status == JobStatus::Running) entry.second->cancelRequested.store(true);
+    }
+    wake.notify_all();
+    if (executor.joinable()) executor.join();
+}
+
+void JobManager::registerKind(const std::string &kind, JobFn fn) {
+    std::lock_guard<std::mutex> lock(mutex);
+    kinds[kind] = std::move(fn);
+}
+
+bool JobManager::hasKind(const std::string &kind) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return kinds.count(kind) > 0;
+}
+
+int JobManager::submit(const std::string &kind, const std::string &params,
+                       std::shared_ptr<const CsrGraph> snapshot) {
+    if (!snapshot) return -1;
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!kinds.count(kind) || stopping) return -1;
+
+    std::shared_ptr<Job> job(new Job());
+    job->id = nextId++;
+    job->kind = kind;
+    job->params = parseParams(params);
+    job->snapshot = std::move(snapshot);
+    job->status = JobStatus::Queued;
+    job->cancelRequested.store(false);
+    job->submitted = Clock::now();
+    jobs[job->id] = job;
+    queue.push_back(job);
+
+    // The executor starts with the first job
+    if (!executor.joinable()) executor = std::thread(&JobManager::run, this);
+    wake.notify_one();
+    return job->id;
+}
+
+bool JobManager::info(int id, JobInfo &out) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = jobs.find(id);
+    if (it == jobs.end()) return false;
+    const Job &job = *it->second;
+
+    auto ms = [](Clock::time_point a, Clock::time_point b) {
+        return std::chrono::duration<double, std::milli>(b - a).count();
+    };
+    Clock::time_point now = Clock::now();
+    out.id = job.id;
+    out.kind = job.kind;
+    out.status = job.status;
+    out.queuedMs = 0.0;
+    out.runMs = 0.0;
+    out.error = job.error;
+    switch (job.status) {
+        case JobStatus::Queued:
+            out.queuedMs = ms(job.submitted, now);
+            break;
+        case JobStatus::Running:
+            out.queuedMs = ms(job.submitted, job.started);
+            out.runMs = ms(job.started, now);
+            break;
+        default:
+            if (job.started != Clock::time_point()) {
+                out.queuedMs = ms(job.submitted, job.started);
+                out.runMs = ms(job.started, job.finished);
+            } else {
+                out.queuedMs = ms(job.submitted, job.finished);
+            }
+    }
+    return true;
+}
+
+bool JobManager::cancel(int id) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = jobs.find(id);
+    if (it == jobs.end()) return false;
+    std::shared_ptr<Job> job = it->second;
+    if (job->status == JobStatus::Queued) {
+        for (auto q = queue.begin(); q != queue.end(); ++q) {
+            if (*q == job) {
+                queue.erase(q);
+                break;
+            }
+        }
+        finishLocked(job, JobStatus::Cancelled);
+        return true;
+    }
+    if (job->status == JobStatus::Running) {
+        job->cancelRequested.store(true);
+        return true;
+    }
+    return false;
+}
+
+bool JobManager::result(int id, std::string &out) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = jobs.find(id);
+    if (it == jobs.end() || it->second->status != JobStatus::Done) return false;
+    out = it->second->result;
+    return true;
+}
+
+const char *JobManager::statusName(JobStatus status) {
+    switch (status) {
+        case JobStatus::Queued: return "queued";
+        case JobStatus::Running: return "running";
+        case JobStatus::Done: return "done";
+        case JobStatus::Failed: return "failed";
+        case JobStatus::Cancelled: return "cancelled";
+    }
+    return "unknown";
+}
+
+
+// =============================================================
+// 3️⃣ Executor
+// =============================================================
+void JobManager::finishLocked(const std::shared_ptr<Job> &job, JobStatus status) {
+    job->status = status;
+    job->finished = Clock::now();
+    job->snapshot.reset(); // release the snapshot memory early
+    finishedOrder.push_back(job->id);
+    while (finishedOrder.size() > kMaxFinishedJobs) {
+        jobs.erase(finishedOrder.front());
+        finishedOrder.pop_front();
+    }
+}
+
+void JobManager::run() {
+    while (true) {
+        std::shared_ptr<Job> job;
+        JobFn fn;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this]() { return stopping || !queue.empty(); });
+            if (stopping) return;
+            job = queue.front();
+            queue.pop_front();
+            job->status = JobStatus::Running;
+            job->started = Clock::now();
+            fn = kinds[job->kind];
+        }
+
+        JobContext ctx{*job->snapshot, job->params, job->cancelRequested};
+        std::string out, error;
+        bool threw = false;
+        try {
+            out = fn(ctx);
+        } catch (const std::exception &e) {
+            threw = true;
+            error = e.what();
+        } catch (...) {
+            threw = true;
+            error = "unknown exception";
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (job->cancelRequested.load()) {
+            finishLocked(job, JobStatus::Cancelled);
+        } else if (threw || out.empty()) {
+            job->error = std::move(error);
+            finishLocked(job, JobStatus::Failed);
+        } else {
+            job->result = std::move(out);
+            finishLocked(job, JobStatus::Done);
+        }
+    }
+}
@@ -0,0 +1,142 @@
+#ifndef JOB_MANAGER_H
+#define JOB_MANAGER_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <condition_variable>
+#include <unordered_map>
+
+class CsrGraph;
+
+/**
+ * @brief Lifecycle of a background job.
+ */
+enum class JobStatus { Queued, Running, Done, Failed, Cancelled };
+
+/**
+ * @brief What a job function sees: the snapshot taken at submit time,
+ * its parameters, and a cancellation flag to check between phases.
+ */
+struct JobContext {
+    const CsrGraph &graph;
+    const std::unordered_map<std::string, std::string> &params;
+    const std::atomic<bool> &cancelRequested;
+
+    int intParam(const std::string &key, int fallback) const;
+    double doubleParam(const std::string &key, double fallback) const;
+    bool cancelled() const { return cancelRequested.load(); }
+};
+
+/**
+ * @brief A job function returns its result as a JSON document, or an
+ * empty string to report failure. An exception also fails the job, with
+ * its message as the error. Long kernels check cancelled() between
+ * phases and stop early; their partial result is then discarded.
+ */
+using JobFn = std::function<std::string(const JobContext &)>;
+
+/**
+ * @brief Read-only view of a job for polling.
+ */
+struct JobInfo {
+    int id;
+    std::string kind;
+    JobStatus status;
+    double queuedMs;   ///< Time spent waiting for the executor
+    double runMs;      ///< Time spent running (so far, if still running)
+    std::string error; ///< Why a Failed job failed (empty if unknown)
+};
+
+/**
+ * @class JobManager
+ * @brief Runs long analytics off the caller's thread.
+ *
+ * Callers submit a job kind, its parameters and a CSR snapshot; the job
+ * then runs on the manager's own executor thread (its kernels still use
+ * the shared ThreadPool) and never touches the live graph, so the graph
+ * can keep changing meanwhile. Kinds are registered by the owner (corelib).
+ *
+ * Finished jobs are kept for polling; only the most recent
+ * kMaxFinishedJobs results are retained.
+ */
+class JobManager {
+public:
+    JobManager();
+    ~JobManager();
+
+    JobManager(const JobManager &) = delete;
+    JobManager &operator=(const JobManager &) = delete;
+
+    /**
+     * @brief Registers (or replaces) a job kind.
+     */
+    void registerKind(const std::string &kind, JobFn fn);
+    bool hasKind(const std::string &kind) const;
+
+    /**
+     * @brief Queues a job.
+     * @param params "key=value" pairs separated by '&' or ','
+     * @return Job id, or -1 for an unknown kind or missing snapshot
+     */
+    int submit(const std::string &kind, const std::string &params, std::shared_ptr<const CsrGraph> snapshot);
+
+    /**
+     * @brief Looks up a job.
+     * @return false if the id is unknown (or its result was evicted)
+     */
+    bool info(int id, JobInfo &out) const;
+
+    /**
+     * @brief Cancels a job: queued jobs never start; running jobs are asked
+     * to stop and their result is discarded.
+     * @return false if the job is unknown or already finished
+     */
+    bool cancel(int id);
+
+    /**
+     * @brief Result JSON of a finished job.
+     * @return false unless the job is Done
+     */
+    bool result(int id, std::string &out) const;
+
+    static const char *statusName(JobStatus status);
+
+private:
+    static const size_t kMaxFinishedJobs = 64;
+    using Clock = std::chrono::steady_clock;
+
+    struct Job {
+        int id;
+        std::string kind;
+        std::unordered_map<std::string, std::string> params;
+        std::shared_ptr<const CsrGraph> snapshot;
+        JobStatus status;
+        std::atomic<bool> cancelRequested;
+        std::string result;
+        std::string error;
+        Clock::time_point submitted, started, finished;
+    };
+
+    mutable std::mutex mutex;                       // guards everything below
+    std::condition_variable wake;
+    std::unordered_map<std::string, JobFn> kinds;
+    std::unordered_map<int, std::shared_ptr<Job>> jobs;
+    std::deque<std::shared_ptr<Job>> queue;
+    std::deque<int> finishedOrder;                  // oldest first, for eviction
+    int nextId;
+    bool stopping;
+    std::thread executor;
+
+    void run();
+    void finishLocked(const std::shared_ptr<Job> &job, JobStatus status);
+    static std::unordered_map<std::string, std::string> parseParams(const std::string &params);
+};
+
+#endif // JOB_MANAGER_H
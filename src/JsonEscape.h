@@ -0,0 +1,29 @@
+#ifndef JSON_ESCAPE_H
+#define JSON_ESCAPE_H
+
+#include <string>
+#include <string_view>
+
+/**
+ * @brief Escapes @p in for use inside a JSON string literal (quotes,
+ * backslashes and the common control characters).
+ */
+inline std::string json_escape(std::string_view in) {
+    std::string out;
+    out.reserve(in.size() + 10);
+    for (char c : in) {
+        switch (c) {
+            case '\"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\b': out += "\\b"; break;
+            case '\f': out += "\\f"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default: out.push_back(c);
+        }
+    }
+    return out;
+}
+
+#endif // JSON_ESCAPE_H
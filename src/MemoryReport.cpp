@@ -0,0 +1,59 @@
+#include "MemoryReport.h"
+#include "JsonEscape.h"
+#include <sstream>
+#include <iomanip>
+
+void MemoryReport::add(const std::string &subsystem, size_t bytes, size_t objects) {
+    for (auto &e : entries) {
+        if (e.subsystem == subsystem) {
+            e.bytes += bytes;
+            e.objects += objects;
+            return;
+        }
+    }
+    entries.push_back({subsystem, bytes, objects});
+}
+
+void MemoryReport::warn(const std::string &message) {
+    warnings.push_back(message);
+}
+
+// Tables this small are not worth a warning even when mostly empty.
+static const size_t kMinBucketsToWarn = 1024;
+
+void MemoryReport::checkLoadFactor(const std::string &name, size_t size, size_t buckets) {
+    if (buckets < kMinBucketsToWarn) return;
+    double lf = (double)size / (double)buckets;
+    if (lf >= 0.25) return;
+    std::ostringstream oss;
+    oss << name << ": load factor " << std::fixed << std::setprecision(3) << lf
+        << " (" << size << " elements in " << buckets << " buckets, ~"
+        << (buckets - size) * sizeof(void*) << " bytes of empty buckets); rehash or reserve smaller";
+    warnings.push_back(oss.str());
+}
+
+size_t MemoryReport::totalBytes() const {
+    size_t total = 0;
+    for (auto &e : entries) total += e.bytes;
+    return total;
+}
+
+std::string MemoryReport::toJson() const {
+    std::ostringstream oss;
+    oss << "{\"total_bytes\":" << totalBytes() << ",\"subsystems\":[";
+    for (size_t i = 0; i < entries.size(); ++i) {
+        if (i) oss << ",";
+        oss << "{";
+        oss << "\"name\":\"" << json_escape(entries[i].subsystem) << "\",";
+        oss << "\"bytes\":" << entries[i].bytes << ",";
+        oss << "\"objects\":" << entries[i].objects;
+        oss << "}";
+    }
+    oss << "],\"warnings\":[";
+    for (size_t i = 0; i < warnings.size(); ++i) {
+        if (i) oss << ",";
+        oss << "\"" << json_escape(warnings[i]) << "\"";
+    }
+    oss << "]}";
+    return oss.str();
+}
@@ -0,0 +1,90 @@
+#ifndef MEMORY_REPORT_H
+#define MEMORY_REPORT_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <unordered_map>
+#include <unordered_set>
+
+/**
+ * @class MemoryReport
+ * @brief Collects per-subsystem byte and object counts for the in-memory graph.
+ *
+ * Subsystems describe themselves through a `reportMemory(MemoryReport&)`
+ * method using the estimators below. The estimators model the libstdc++ /
+ * libc++ node layouts (one heap node per element plus the bucket array),
+ * rounded to the 16-byte malloc granularity, so they are close but not exact.
+ */
+class MemoryReport {
+public:
+    struct Entry {
+        std::string subsystem;
+        size_t bytes;
+        size_t objects;
+    };
+
+    /**
+     * @brief Adds (or accumulates into) one subsystem line.
+     */
+    void add(const std::string &subsystem, size_t bytes, size_t objects);
+
+    /**
+     * @brief Records a human-readable warning about wasted memory.
+     */
+    void warn(const std::string &message);
+
+    /**
+     * @brief Warns when a hash table keeps far more buckets than elements.
+     * @param name Subsystem name used in the message.
+     * @param size Element count.
+     * @param buckets Bucket count.
+     */
+    void checkLoadFactor(const std::string &name, size_t size, size_t buckets);
+
+    size_t totalBytes() const;
+    std::string toJson() const;
+
+    // ----------------------------
+    // Estimators
+    // ----------------------------
+
+    /// Size of one malloc'd block of @p n bytes (16-byte granularity).
+    static size_t heapBlock(size_t n) { return n == 0 ? 0 : (n + 15) & ~size_t(15); }
+
+    /// Heap bytes owned by a string (0 while it fits the small-string buffer).
+    static size_t stringBytes(const std::string &s) {
+        const char *self = reinterpret_cast<const char*>(&s);
+        bool inlineBuf = s.data() >= self && s.data() < self + sizeof(std::string);
+        return inlineBuf ? 0 : heapBlock(s.capacity() + 1);
+    }
+
+    /// Bucket array plus one node per element; excludes heap owned by elements.
+    /// A single bucket is stored inline by empty tables and costs nothing extra.
+    template <class V>
+    static size_t hashTableBytes(size_t size, size_t buckets) {
+        size_t bucketBytes = buckets > 1 ? heapBlock(buckets * sizeof(void*)) : 0;
+        return bucketBytes + size * heapBlock(2 * sizeof(void*) + sizeof(V));
+    }
+
+    template <class K, class V>
+    static size_t tableBytes(const std::unordered_map<K, V> &m) {
+        return hashTableBytes<std::pair<const K, V>>(m.size(), m.bucket_count());
+    }
+
+    template <class K>
+    static size_t tableBytes(const std::unordered_set<K> &s) {
+        return hashTableBytes<K>(s.size(), s.bucket_count());
+    }
+
+    template <class T>
+    static size_t vectorBytes(const std::vector<T> &v) {
+        return heapBlock(v.capacity() * sizeof(T));
+    }
+
+private:
+    std::vector<Entry> entries;
+    std::vector<std::string> warnings;
+};
+
+#endif // MEMORY_REPORT_H
@@ -0,0 +1,58 @@
+#include "NameArena.h"
+#include "MemoryReport.h"
+#include <cstring>
+
+std::string_view NameArena::add(std::string_view name) {
+    ++live;
+    liveBytes += name.size();
+    if (name.empty()) return std::string_view();
+
+    char *dst;
+    if (name.size() > kChunkSize / 4) {
+        large.emplace_back(new char[name.size()]);
+        largeBytes += name.size();
+        dst = large.back().get();
+    } else {
+        if (used + name.size() > kChunkSize) {
+            chunks.emplace_back(new char[kChunkSize]);
+            used = 0;
+        }
+        dst = chunks.back().get() + used;
+        used += name.size();
+    }
+    std::memcpy(dst, name.data(), name.size());
+    return std::string_view(dst, name.size());
+}
+
+void NameArena::release(std::string_view name) {
+    if (live == 0) return;
+    --live;
+    liveBytes -= name.size();
+    deadBytes += name.size();
+}
+
+void NameArena::clear() {
+    chunks.clear();
+    large.clear();
+    live = liveBytes = deadBytes = largeBytes = 0;
+    used = kChunkSize;
+    ++gen;
+}
+
+void NameArena::adopt(NameArena &&fresh) {
+    uint64_t next = gen + 1;
+    chunks = std::move(fresh.chunks);
+    large = std::move(fresh.large);
+    live = fresh.live;
+    liveBytes = fresh.liveBytes;
+    deadBytes = fresh.deadBytes;
+    used = fresh.used;
+    largeBytes = fresh.largeBytes;
+    gen = next;
+    fresh.clear();
+}
+
+size_t NameArena::memoryBytes() const {
+    return MemoryReport::vectorBytes(chunks) + MemoryReport::vectorBytes(large) +
+           chunks.size() * MemoryReport::heapBlock(kChunkSize) + MemoryReport::heapBlock(largeBytes);
+}
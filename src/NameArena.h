@@ -0,0 +1,59 @@
+#ifndef NAME_ARENA_H
+#define NAME_ARENA_H
+
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @class NameArena
+ * @brief Append-only storage for user names.
+ *
+ * Names are copied back to back into fixed-size chunks; each one is
+ * addressed by its chunk and offset and handed out as a string_view.
+ * Chunks never move, so views stay valid as the arena grows. CoreGraph
+ * owns the arena and every other subsystem (name lookup, autocomplete)
+ * refers to the same bytes instead of keeping its own copy.
+ *
+ * Removing a name only counts its bytes as dead. The owner rebuilds the
+ * arena once dead bytes dominate; that and clear() bump generation(), so
+ * holders of views know to re-fetch them.
+ */
+class NameArena {
+public:
+    NameArena() : gen(0), live(0), liveBytes(0), deadBytes(0), used(kChunkSize), largeBytes(0) {}
+
+    std::string_view add(std::string_view name);   ///< Copies @p name in, returns its stable view
+    void release(std::string_view name);           ///< Marks a name's bytes dead
+    void clear();
+
+    /**
+     * @brief Replaces the contents with @p fresh (normally a compacted
+     * copy) and bumps the generation, invalidating every earlier view.
+     */
+    void adopt(NameArena &&fresh);
+
+    bool wantsCompaction() const { return deadBytes > kChunkSize && deadBytes > liveBytes; }
+
+    uint64_t generation() const { return gen; }
+    size_t size() const { return live; }           ///< Live names
+    size_t bytes() const { return liveBytes; }     ///< Bytes of live names
+    size_t wasted() const { return deadBytes; }    ///< Bytes of released names
+    size_t memoryBytes() const;
+
+private:
+    static constexpr size_t kChunkSize = 64 * 1024;
+
+    std::vector<std::unique_ptr<char[]>> chunks;   // kChunkSize bytes each
+    std::vector<std::unique_ptr<char[]>> large;    // names over a quarter chunk, one block each
+    uint64_t gen;
+    size_t live;
+    size_t liveBytes;
+    size_t deadBytes;
+    size_t used;                                   // bytes used in chunks.back()
+    size_t largeBytes;
+};
+
+#endif // NAME_ARENA_H
@@ -0,0 +1,222 @@
+#include "NeighborList.h"
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+// =============================================================
+// BlockPool
+// =============================================================
+BlockPool::BlockPool()
+    : slabCur(nullptr), slabLeft(0), slabBytes(0), largeBytes(0), inUseBytes(0) {
+    for (auto &f : freeLists) f = nullptr;
+}
+
+BlockPool::~BlockPool() {
+    clear();
+}
+
+int BlockPool::classOf(uint32_t capacity) {
+    return __builtin_ctz(capacity) - __builtin_ctz(kMinBlock);
+}
+
+int *BlockPool::allocate(uint32_t capacity) {
+    size_t bytes = (size_t)capacity * sizeof(int);
+    inUseBytes += bytes;
+    int c = classOf(capacity);
+    if (c >= kClasses) {
+        largeBytes += bytes;
+        return static_cast<int*>(::operator new(bytes));
+    }
+
+    // Recycle a block of the same class if one is free.
+    if (freeLists[c]) {
+        void *p = freeLists[c];
+        freeLists[c] = *static_cast<void**>(p);
+        return static_cast<int*>(p);
+    }
+
+    if (slabLeft < bytes) {
+        char *slab = new char[kSlabBytes];
+        slabs.push_back(slab);
+        slabBytes += kSlabBytes;
+        slabCur = slab;
+        slabLeft = kSlabBytes;
+    }
+    int *p = reinterpret_cast<int*>(slabCur);
+    slabCur += bytes;
+    slabLeft -= bytes;
+    return p;
+}
+
+void BlockPool::release(int *block, uint32_t capacity) {
+    if (!block) return;
+    size_t bytes = (size_t)capacity * sizeof(int);
+    inUseBytes -= bytes;
+    int c = classOf(capacity);
+    if (c >= kClasses) {
+        largeBytes -= bytes;
+        ::operator delete(block);
+        return;
+    }
+    *reinterpret_cast<void**>(block) = freeLists[c];
+    freeLists[c] = block;
+}
+
+void BlockPool::clear() {
+    for (char *s : slabs) delete[] s;
+    slabs.clear();
+    for (auto &f : freeLists) f = nullptr;
+    slabCur = nullptr;
+    slabLeft = 0;
+    slabBytes = 0;
+    inUseBytes = largeBytes;
+}
+
+
+// =============================================================
+// NeighborList
+// =============================================================
+static uint32_t nextPow2(uint32_t v) {
+    uint32_t p = BlockPool::kMinBlock;
+    while (p < v) p <<= 1;
+    return p;
+}
+
+// Fibonacci hashing; the table size is a power of two.
+uint32_t NeighborList::slotOf(int v) const {
+    uint32_t h = (uint32_t)v * 2654435761u;
+    return h >> (32 - __builtin_ctz(cap));
+}
+
+void NeighborList::hubInsert(int v) {
+    uint32_t mask = cap - 1;
+    uint32_t i = slotOf(v);
+    while (data[i] != kEmpty) i = (i + 1) & mask;
+    data[i] = v;
+}
+
+bool NeighborList::contains(int v) const {
+    if (count == 0) return false;
+    if (isSorted()) return std::binary_search(data, data + count, v);
+    uint32_t mask = cap - 1;
+    for (uint32_t i = slotOf(v); data[i] != kEmpty; i = (i + 1) & mask) {
+        if (data[i] == v) return true;
+    }
+    return false;
+}
+
+void NeighborList::rebuild(uint32_t newCap, BlockPool &pool) {
+    int *old = data;
+    uint32_t oldCap = cap;
+    bool wasSorted = isSorted();
+
+    data = pool.allocate(newCap);
+    cap = newCap;
+    if (isSorted()) {
+        if (wasSorted) {
+            if (count) std::memcpy(data, old, count * sizeof(int));
+        } else {
+            uint32_t n = 0;
+            for (uint32_t i = 0; i < oldCap; ++i)
+                if (old[i] != kEmpty) data[n++] = old[i];
+            std::sort(data, data + n);
+        }
+    } else {
+        std::fill(data, data + cap, kEmpty);
+        uint32_t oldSlots = wasSorted ? count : oldCap;
+        for (uint32_t i = 0; i < oldSlots; ++i)
+            if (old[i] != kEmpty) hubInsert(old[i]);
+    }
+    pool.release(old, oldCap);
+}
+
+bool NeighborList::insert(int v, BlockPool &pool) {
+    if (isSorted()) {
+        int *pos = std::lower_bound(data, data + count, v);
+        if (pos != data + count && *pos == v) return false;
+        if (count < cap) {
+            std::memmove(pos + 1, pos, (data + count - pos) * sizeof(int));
+            *pos = v;
+            ++count;
+            return true;
+        }
+        // Full: double the array, or switch to a hash table past kSortedMax.
+        uint32_t want = cap ? cap * 2 : BlockPool::kMinBlock;
+        if (want > kSortedMax) want = nextPow2(2 * (count + 1));
+        rebuild(want, pool);
+        return insert(v, pool);
+    }
+
+    if (contains(v)) return false;
+    if ((count + 1) * 2 > cap) rebuild(cap * 2, pool);
+    hubInsert(v);
+    ++count;
+    return true;
+}
+
+bool NeighborList::erase(int v, BlockPool &pool) {
+    if (count == 0) return false;
+    if (isSorted()) {
+        int *pos = std::lower_bound(data, data + count, v);
+        if (pos == data + count || *pos != v) return false;
+        std::memmove(pos, pos + 1, (data + count - pos - 1) * sizeof(int));
+        --count;
+        if (count == 0) release(pool);
+        else if (cap > BlockPool::kMinBlock && count * 4 <= cap) rebuild(cap / 2, pool);
+        return true;
+    }
+
+    uint32_t mask = cap - 1;
+    uint32_t i = slotOf(v);
+    while (data[i] != v) {
+        if (data[i] == kEmpty) return false;
+        i = (i + 1) & mask;
+    }
+    // Backward-shift deletion keeps probe chains intact without tombstones.
+    uint32_t j = i;
+    while (true) {
+        j = (j + 1) & mask;
+        if (data[j] == kEmpty) break;
+        uint32_t k = slotOf(data[j]);
+        bool movable = (i <= j) ? (k <= i || k > j) : (k <= i && k > j);
+        if (movable) {
+            data[i] = data[j];
+            i = j;
+        }
+    }
+    data[i] = kEmpty;
+    --count;
+
+    if (count < kSortedMax / 2) rebuild(nextPow2(count), pool);
+    return true;
+}
+
+void NeighborList::assign(const int *sorted, uint32_t n, BlockPool &pool) {
+    release(pool);
+    if (n == 0) return;
+    // Same shape insert() would reach: a sorted array up to kSortedMax,
+    // otherwise a hash table at most half full.
+    uint32_t want = n <= kSortedMax ? nextPow2(n) : nextPow2(2 * n);
+    data = pool.allocate(want);
+    cap = want;
+    count = n;
+    if (isSorted()) {
+        std::memcpy(data, sorted, n * sizeof(int));
+    } else {
+        std::fill(data, data + cap, kEmpty);
+        for (uint32_t i = 0; i < n; ++i) hubInsert(sorted[i]);
+    }
+}
+
+void NeighborList::appendSorted(std::vector<int> &out) const {
+    size_t start = out.size();
+    out.insert(out.end(), begin(), end());
+    if (!isSorted()) std::sort(out.begin() + start, out.end());
+}
+
+void NeighborList::release(BlockPool &pool) {
+    pool.release(data, cap);
+    data = nullptr;
+    count = 0;
+    cap = 0;
+}
@@ -0,0 +1,133 @@
+#ifndef NEIGHBOR_LIST_H
+#define NEIGHBOR_LIST_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <iterator>
+
+/**
+ * @class BlockPool
+ * @brief Size-classed allocator for neighbor blocks.
+ *
+ * Blocks are power-of-two arrays of ints. Small classes are carved out of
+ * large slabs and recycled through intrusive free lists, so adding a friend
+ * never touches the general-purpose heap once the pool is warm. Blocks above
+ * the largest pooled class are allocated individually.
+ */
+class BlockPool {
+public:
+    BlockPool();
+    ~BlockPool();
+    BlockPool(const BlockPool &) = delete;
+    BlockPool &operator=(const BlockPool &) = delete;
+
+    /**
+     * @brief Allocates a block of @p capacity ints (power of two, >= kMinBlock).
+     */
+    int *allocate(uint32_t capacity);
+
+    /**
+     * @brief Returns a block previously obtained from allocate() with the same capacity.
+     */
+    void release(int *block, uint32_t capacity);
+
+    /**
+     * @brief Drops every slab. All blocks handed out become invalid; blocks
+     * larger than the biggest pooled class must be released first.
+     */
+    void clear();
+
+    size_t reservedBytes() const { return slabBytes + largeBytes; } ///< Bytes obtained from the heap
+    size_t usedBytes() const { return inUseBytes; }                 ///< Bytes in live blocks
+
+    static constexpr uint32_t kMinBlock = 4;
+
+private:
+    static constexpr int kClasses = 11;             // 4 .. 4096 ints
+    static constexpr size_t kSlabBytes = 256 * 1024;
+
+    void *freeLists[kClasses];
+    std::vector<char*> slabs;
+    char *slabCur;
+    size_t slabLeft;
+    size_t slabBytes, largeBytes, inUseBytes;
+
+    static int classOf(uint32_t capacity);
+};
+
+/**
+ * @class NeighborList
+ * @brief Contiguous neighbor storage for one user.
+ *
+ * Low-degree users keep a sorted array; once the degree passes kSortedMax
+ * the block is rebuilt as an open-addressing hash set (linear probing,
+ * load factor <= 1/2, backward-shift deletion), and it is turned back into
+ * a sorted array when the degree drops below half of that. Blocks come from
+ * the owning graph's BlockPool, which must be passed to every mutation.
+ *
+ * Iteration visits every neighbor exactly once; it is in ascending order
+ * only while isSorted() is true.
+ */
+class NeighborList {
+public:
+    static constexpr int kEmpty = -1;         ///< Free slot marker in hub tables
+    static constexpr uint32_t kSortedMax = 128; ///< Largest degree kept as a sorted array
+
+    class const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = int;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const int*;
+        using reference = int;
+
+        const_iterator(const int *p, const int *e) : p(p), e(e) { skip(); }
+        int operator*() const { return *p; }
+        const_iterator &operator++() { ++p; skip(); return *this; }
+        bool operator!=(const const_iterator &o) const { return p != o.p; }
+        bool operator==(const const_iterator &o) const { return p == o.p; }
+    private:
+        void skip() { while (p != e && *p == kEmpty) ++p; }
+        const int *p, *e;
+    };
+
+    NeighborList() : data(nullptr), count(0), cap(0) {}
+
+    uint32_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    bool isSorted() const { return cap <= kSortedMax; }
+
+    /// Sorted neighbor array (valid only while isSorted()).
+    const int *sortedData() const { return data; }
+
+    const_iterator begin() const { return const_iterator(data, data + slots()); }
+    const_iterator end() const { return const_iterator(data + slots(), data + slots()); }
+
+    bool contains(int v) const;
+    bool insert(int v, BlockPool &pool);
+    bool erase(int v, BlockPool &pool);
+
+    /// Replaces the contents with @p n sorted, distinct ids using a single block.
+    void assign(const int *sorted, uint32_t n, BlockPool &pool);
+
+    /// Appends all neighbors to @p out, in ascending order.
+    void appendSorted(std::vector<int> &out) const;
+
+    /// Returns the block to the pool and empties the list.
+    void release(BlockPool &pool);
+
+    size_t blockBytes() const { return (size_t)cap * sizeof(int); }
+
+private:
+    int *data;
+    uint32_t count;
+    uint32_t cap;
+
+    uint32_t slots() const { return isSorted() ? count : cap; }
+    uint32_t slotOf(int v) const;
+    void rebuild(uint32_t newCap, BlockPool &pool);
+    void hubInsert(int v);
+};
+
+#endif // NEIGHBOR_LIST_H
@@ -0,0 +1,9 @@
+#include "Parallel.h"
+
+unsigned parallelWorkers() {
+    return ThreadPool::instance().size();
+}
+
+void setParallelWorkers(unsigned n) {
+    if (n != ThreadPool::instance().size() || n == 0) ThreadPool::instance().resize(n);
+}
@@ -0,0 +1,133 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include "ThreadPool.h"
+#include <atomic>
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+
+/**
+ * @brief Number of workers parallel loops may use (>= 1).
+ * This is the size of the shared ThreadPool, by default the hardware concurrency.
+ */
+unsigned parallelWorkers();
+
+/**
+ * @brief Resizes the shared ThreadPool; 0 restores the default.
+ * Waits for running loops; ignored inside a ParallelScope or loop body.
+ */
+void setParallelWorkers(unsigned n);
+
+/**
+ * @brief Keeps parallelWorkers() fixed while alive (see ThreadPool::Pin).
+ *
+ * Loops take one themselves. Code that sizes per-worker scratch before a
+ * loop must open a scope first, so a concurrent setParallelWorkers()
+ * cannot hand the loop more workers than the scratch has slots.
+ */
+class ParallelScope {
+public:
+    ParallelScope() : pin(ThreadPool::instance()) {}
+    unsigned workers() const { return pin.workers(); }
+
+private:
+    ThreadPool::Pin pin;
+};
+
+/**
+ * @brief Runs @p fn over [begin, end) in chunks of @p grain indices.
+ *
+ * @p fn is called as fn(lo, hi, worker) where worker < parallelWorkers()
+ * is unique among the concurrently running calls of this loop, so it can
+ * index per-worker scratch space. Chunks are handed out dynamically, which
+ * balances skewed work such as high-degree vertices. The loop runs on the
+ * shared ThreadPool and may be nested.
+ */
+template <class Fn>
+void parallelFor(size_t begin, size_t end, size_t grain, Fn &&fn) {
+    if (begin >= end) return;
+    if (grain == 0) grain = 1;
+    size_t chunks = (end - begin + grain - 1) / grain;
+    ParallelScope scope;
+    size_t workers = scope.workers();
+    if (workers > chunks) workers = chunks;
+    if (workers <= 1) {
+        fn(begin, end, 0u);
+        return;
+    }
+
+    // Each runner claims a slot index once, then drains chunks.
+    std::atomic<size_t> next(begin);
+    std::atomic<unsigned> slots(0);
+    ThreadPool::instance().runReplicated((unsigned)workers, [&]() {
+        unsigned worker = slots.fetch_add(1);
+        while (true) {
+            size_t lo = next.fetch_add(grain);
+            if (lo >= end) break;
+            size_t hi = lo + grain < end ? lo + grain : end;
+            fn(lo, hi, worker);
+        }
+    });
+}
+
+/**
+ * @brief Parallel map-reduce over [begin, end).
+ *
+ * @p map(lo, hi) returns the partial result of one chunk; partials are
+ * folded per worker with @p combine, then combined in worker order.
+ * @p combine must be associative (and commutative for chunk order to
+ * not matter).
+ */
+template <class T, class Map, class Combine>
+T parallelReduce(size_t begin, size_t end, size_t grain, T identity, Map &&map, Combine &&combine) {
+    ParallelScope scope;
+    std::vector<T> partial(scope.workers(), identity);
+    parallelFor(begin, end, grain, [&](size_t lo, size_t hi, unsigned worker) {
+        partial[worker] = combine(partial[worker], map(lo, hi));
+    });
+    T result = identity;
+    for (auto &p : partial) result = combine(result, p);
+    return result;
+}
+
+/**
+ * @brief Sorts [first, last) on the shared ThreadPool.
+ *
+ * The range is cut into a power-of-two number of chunks that are sorted
+ * in parallel, then merged pairwise in rounds (each round's merges run in
+ * parallel). Small ranges and single-worker pools use std::sort.
+ */
+template <class It, class Compare>
+void parallelSort(It first, It last, Compare comp) {
+    size_t n = (size_t)(last - first);
+    ParallelScope scope;
+    size_t workers = scope.workers();
+    if (workers <= 1 || n < 65536) {
+        std::sort(first, last, comp);
+        return;
+    }
+    size_t chunks = 1;
+    while (chunks < workers) chunks <<= 1;
+    size_t size = (n + chunks - 1) / chunks;
+    auto bound = [&](size_t c) { return first + (std::ptrdiff_t)std::min(n, c * size); };
+
+    parallelFor(0, chunks, 1, [&](size_t lo, size_t hi, unsigned) {
+        for (size_t c = lo; c < hi; ++c) std::sort(bound(c), bound(c + 1), comp);
+    });
+    for (size_t width = 1; width < chunks; width *= 2) {
+        parallelFor(0, chunks / (2 * width), 1, [&](size_t lo, size_t hi, unsigned) {
+            for (size_t p = lo; p < hi; ++p) {
+                size_t c = p * 2 * width;
+                std::inplace_merge(bound(c), bound(c + width), bound(c + 2 * width), comp);
+            }
+        });
+    }
+}
+
+template <class It>
+void parallelSort(It first, It last) {
+    parallelSort(first, last, [](const auto &a, const auto &b) { return a < b; });
+}
+
+#endif // PARALLEL_H
@@ -1,15 +1,21 @@
 #include "Persistence.h"
 #include "CoreGraph.h"
+#include "MemoryReport.h"
+#include "Parallel.h"
+#include "GraphVersion.h"
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <algorithm>
+#include <vector>
+#include <cstdlib>
 
-Persistence::Persistence(CoreGraph *g) : graph(g) {
+Persistence::Persistence(CoreGraph *g) : graph(g), nameGeneration(0) {
     rebuildNameIndex();
 }
 
 // Escape reserved characters
-std::string Persistence::escape(const std::string &s) {
+std::string Persistence::escape(std::string_view s) {
     std::string out;
     for (char c : s) {
         if (c == '|' || c == '\\' || c == ',') out.push_back('\\');
@@ -40,34 +46,48 @@ std::string Persistence::unescape(const std::string &s) {
 // =============================================================
 bool Persistence::saveToFile(const std::string &filename) {
     if (!graph) return false;
+    return saveVersion(*graph->pin(), filename);
+}
+
+bool Persistence::saveVersion(const GraphVersion &image, const std::string &filename) {
     std::ofstream ofs(filename);
     if (!ofs.is_open()) return false;
 
-    auto ids = graph->listAllUsers();
-    ofs << "USERS " << ids.size() << "\n";
-    for (int id : ids) {
-        const User* u = graph->getUser(id);
-        if (!u) continue;
-        ofs << id << "|" << escape(u->name) << "|";
-
-        // Save interests (comma-separated)
-        bool first = true;
-        for (auto &intr : u->interests) {
-            if (!first) ofs << ",";
-            ofs << escape(intr);
-            first = false;
+    // Users are formatted in parallel blocks (the image is immutable),
+    // then the blocks are written out in order.
+    const size_t kBlock = 4096;
+    size_t blocks = (image.size() + kBlock - 1) / kBlock;
+    std::vector<std::string> userText(blocks), edgeText(blocks);
+    parallelFor(0, blocks, 1, [&](size_t lo, size_t hi, unsigned) {
+        for (size_t b = lo; b < hi; ++b) {
+            std::ostringstream users, edges;
+            size_t last = std::min(image.size(), (b + 1) * kBlock);
+            for (size_t i = b * kBlock; i < last; ++i) {
+                const GraphVersion::Row &u = image.row(i);
+                users << u.id << "|" << escape(u.name) << "|";
+
+                // Save interests (comma-separated)
+                bool first = true;
+                for (auto &intr : u.interests) {
+                    if (!first) users << ",";
+                    users << escape(intr);
+                    first = false;
+                }
+                users << "\n";
+
+                for (int v : u.friends) {
+                    if (u.id < v) edges << u.id << " " << v << "\n";
+                }
+            }
+            userText[b] = users.str();
+            edgeText[b] = edges.str();
         }
-        ofs << "\n";
-    }
+    });
 
+    ofs << "USERS " << image.size() << "\n";
+    for (auto &text : userText) ofs << text;
     ofs << "EDGES\n";
-    auto adj = graph->getAdjacency();
-    for (auto &kv : adj) {
-        int u = kv.first;
-        for (int v : kv.second) {
-            if (u < v) ofs << u << " " << v << "\n";
-        }
-    }
+    for (auto &text : edgeText) ofs << text;
 
     ofs.close();
     return true;
@@ -128,12 +148,19 @@ bool Persistence::loadFromFile(const std::string &filename) {
     if (!std::getline(ifs, line)) return false;
     if (line != "EDGES") return false;
 
+    // Collected first, then built in one bulk pass
+    std::vector<std::pair<int,int>> edges;
     while (std::getline(ifs, line)) {
         if (line.empty()) continue;
-        std::stringstream ss2(line);
-        int u, v;
-        if (ss2 >> u >> v) graph->addFriend(u, v);
+        char *end = nullptr;
+        long u = std::strtol(line.c_str(), &end, 10);
+        if (end == line.c_str()) continue;
+        char *next = nullptr;
+        long v = std::strtol(end, &next, 10);
+        if (next == end) continue;
+        edges.push_back({(int)u, (int)v});
     }
+    graph->addFriendsBulk(edges);
 
     rebuildNameIndex();
     return true;
@@ -145,7 +172,9 @@ bool Persistence::loadFromFile(const std::string &filename) {
 void Persistence::rebuildNameIndex() {
     nameIndex.clear();
     if (!graph) return;
-    auto ids = graph->listAllUsers();
+    nameGeneration = graph->names().generation();
+    const auto &ids = graph->userIds();
+    nameIndex.reserve(ids.size());
     for (int id : ids) {
         const User* u = graph->getUser(id);
         if (!u) continue;
@@ -157,7 +186,17 @@ void Persistence::rebuildNameIndex() {
 // Lookup user ID by name
 // =============================================================
 int Persistence::findUserIdByName(const std::string &name) {
+    if (graph && graph->names().generation() != nameGeneration) rebuildNameIndex();
     auto it = nameIndex.find(name);
     if (it == nameIndex.end()) return -1;
     return it->second;
+}
+
+// =============================================================
+// Memory accounting
+// =============================================================
+void Persistence::reportMemory(MemoryReport &report) const {
+    size_t bytes = MemoryReport::tableBytes(nameIndex); // keys view the graph's arena
+    report.add("persistence.name_index", bytes, nameIndex.size());
+    report.checkLoadFactor("persistence.name_index", nameIndex.size(), nameIndex.bucket_count());
 }
\ No newline at end of file
@@ -2,12 +2,16 @@
 #define PERSISTENCE_H
 
 #include <string>
+#include <string_view>
 #include <unordered_map>
+#include <cstdint>
 
 /**
  * @brief Forward declaration of CoreGraph to avoid circular dependency.
  */
 class CoreGraph;
+class GraphVersion;
+class MemoryReport;
 
 /**
  * @class Persistence
@@ -32,6 +36,16 @@ public:
      */
     bool saveToFile(const std::string &filename);
 
+    /**
+     * @brief Saves a pinned graph version (see CoreGraph::pin()).
+     *
+     * Reads only @p image, so it may run on any thread while the graph
+     * keeps changing; the file is the graph exactly as it was pinned.
+     * saveToFile() pins the current version and calls this.
+     * @return true if successful, false otherwise.
+     */
+    bool saveVersion(const GraphVersion &image, const std::string &filename);
+
     /**
      * @brief Loads users, their interests, and friendships from a file.
      * @param filename File path to load from (e.g., "users.txt").
@@ -41,25 +55,36 @@ public:
 
     /**
      * @brief Rebuilds the name-to-ID index from the graph data.
+     *
+     * Keys are views into the graph's name arena, so no name is copied.
      */
     void rebuildNameIndex();
 
     /**
      * @brief Finds a user's ID by name.
+     *
+     * Rebuilds the index first if the arena's generation moved on since
+     * the last rebuild, so the keys never outlive the names they view.
      * @param name User’s name.
      * @return User ID if found, -1 otherwise.
      */
     int findUserIdByName(const std::string &name);
 
+    /**
+     * @brief Reports the bytes held by the name index.
+     */
+    void reportMemory(MemoryReport &report) const;
+
 private:
     CoreGraph *graph;  ///< Pointer to the main social graph.
-    std::unordered_map<std::string, int> nameIndex;  ///< Name → ID lookup map.
+    std::unordered_map<std::string_view, int> nameIndex;  ///< Name → ID lookup map (views into CoreGraph::names()).
+    uint64_t nameGeneration;                              ///< Arena generation nameIndex was built against.
 
     /**
      * @brief Escapes reserved characters in file output.
      * Used for names and interests containing special symbols.
      */
-    std::string escape(const std::string &s);
+    std::string escape(std::string_view s);
 
     /**
      * @brief Unescapes strings when loading from file.
@@ -1,71 +1,287 @@
 #include "Recommender.h"
 #include "CoreGraph.h"
+#include "CsrGraph.h"
+#include "Parallel.h"
 #include <unordered_map>
 #include <unordered_set>
-#include <queue>
 #include <cmath>
 #include <algorithm>
 #include <iostream>
+#include <random>
 
 // Constructor
-Recommender::Recommender(const CoreGraph *graph) : G(graph) {}
+Recommender::Recommender(const CoreGraph *graph)
+    : G(graph), cacheCapacity(10000), stats{0, 0, 0, 0, 0, 10000} {}
 
 
 // =============================================================
-// 1️⃣ Basic Recommendation Based on Mutual Friends
+// 1️⃣ Candidate Engine (shared by every strategy)
 // =============================================================
-std::vector<std::pair<int,int>> Recommender::recommendByMutual(int userId, int topK) const {
-    std::vector<std::pair<int,int>> empty;
-    if (!G || !G->getUser(userId)) return empty;
+namespace {
+// Per-thread mutual-friend counters indexed by dense user index, kept
+// between queries: pool threads are long-lived, so the arrays are
+// allocated once per thread and only grow with the graph.
+struct MutualCounter {
+    std::vector<uint32_t> count;
+    std::vector<double> weight; // sum of friendWeights over the mutual friends
+    std::vector<int> touched;   // user ids with a non-zero count
+};
+thread_local MutualCounter tlsCounter;
 
-    // Step 1: Collect all current friends
-    std::unordered_set<int> friendsSet(G->getFriends(userId).begin(), G->getFriends(userId).end());
+struct Scored {
+    double score;
+    int id;
+    uint32_t mutual;
+};
 
-    // Step 2: Count mutual friends for each candidate
-    std::unordered_map<int,int> mutualCount;
-    auto adj = G->getAdjacency();
+// Best first: higher score, then lower id
+inline bool better(const Scored &a, const Scored &b) {
+    if (a.score != b.score) return a.score > b.score;
+    return a.id < b.id;
+}
 
-    for (int f : friendsSet) {
-        auto it = adj.find(f);
-        if (it == adj.end()) continue;
+// Jaccard similarity of two interest sets
+double jaccardSimilarity(const std::unordered_set<std::string> &A,
+                         const std::unordered_set<std::string> &B) {
+    if (A.empty() || B.empty()) return 0.0;
 
-        for (int fof : it->second) {
-            if (fof == userId) continue;
-            if (friendsSet.find(fof) != friendsSet.end()) continue;
-            mutualCount[fof] += 1; // count mutual friend
+    const auto &small = A.size() <= B.size() ? A : B;
+    const auto &large = A.size() <= B.size() ? B : A;
+    int common = 0;
+    for (auto &x : small) if (large.find(x) != large.end()) common++;
+
+    return (double)common / (A.size() + B.size() - common);
+}
+
+// Fixed-size bitset over dense user indices
+class IdBitset {
+public:
+    explicit IdBitset(size_t bound) : words((bound + 63) / 64, 0) {}
+    void set(int id) {
+        if (id >= 0 && (size_t)id < words.size() * 64) words[id >> 6] |= 1ull << (id & 63);
+    }
+    bool test(int id) const {
+        return id >= 0 && (size_t)id < words.size() * 64 && (words[id >> 6] >> (id & 63)) & 1;
+    }
+private:
+    std::vector<uint64_t> words;
+};
+
+// A RecFilter prepared for one query: excluded users go into a bitset and
+// required interests resolve to their InterestIndex posting lists.
+struct CandidateFilter {
+    IdBitset excluded;
+    std::vector<const RoaringBitmap*> required;
+    bool impossible; // some required interest has no users
+
+    CandidateFilter(const CoreGraph &G, const RecFilter &f) : excluded(G.denseBound()), impossible(false) {
+        for (int id : f.excludedUsers) excluded.set(G.denseIndex(id));
+        for (std::string i : f.requiredInterests) {
+            std::transform(i.begin(), i.end(), i.begin(), ::tolower);
+            const RoaringBitmap *p = G.interestIndex().postings(i);
+            if (!p) impossible = true;
+            else required.push_back(p);
         }
     }
 
-    if (mutualCount.empty()) return empty;
+    bool accepts(int c, int index) const {
+        if (impossible || excluded.test(index)) return false;
+        for (const RoaringBitmap *p : required)
+            if (!p->contains((uint32_t)c)) return false;
+        return true;
+    }
+};
+
+// Scores every friend-of-friend of userId that is not already a friend
+// (and passes filter, if any) with score(candidate, mutualCount, weight)
+// and returns the best topK, best first. Filtering happens before
+// selection, so filtered candidates never take a top-K slot. If
+// friendWeight is given, it maps each friend to a weight (computed once
+// per friend) and weight is its sum over the mutual friends; otherwise
+// weight is 0.
+template <class FriendWeightFn, class ScoreFn>
+std::vector<Scored> topCandidates(const CoreGraph &G, int userId, int topK, const CandidateFilter *filter,
+                                  FriendWeightFn &&friendWeight, ScoreFn &&score) {
+    std::vector<Scored> best;
+    if (topK <= 0 || !G.getUser(userId)) return best;
+    MutualCounter &mc = tlsCounter;
+    if (mc.count.size() < G.denseBound()) {
+        mc.count.resize(G.denseBound(), 0);
+        mc.weight.resize(G.denseBound(), 0.0);
+    }
 
-    // Step 3: Rank candidates by number of mutual friends
-    std::priority_queue<std::pair<int,int>> pq;
-    for (auto &p : mutualCount) pq.push({p.second, -p.first});
+    // Step 1: Count mutual friends (and weights) over friends-of-friends
+    const NeighborList &friends = G.neighbors(userId);
+    for (int f : friends) {
+        double w = friendWeight(f);
+        for (int c : G.neighbors(f)) {
+            if (c == userId) continue;
+            int x = G.denseIndex(c);
+            if (mc.count[x]++ == 0) mc.touched.push_back(c);
+            mc.weight[x] += w;
+        }
+    }
 
-    // Step 4: Pick Top-K recommendations
-    std::vector<std::pair<int,int>> result;
-    while (!pq.empty() && (int)result.size() < topK) {
-        auto t = pq.top(); pq.pop();
-        int score = t.first;
-        int cand = -t.second;
-        result.push_back({cand, score});
+    // Step 2: Score non-friends. Keep all of them when K is a large share
+    // of the candidates (then nth_element), otherwise a bounded heap whose
+    // root is the weakest of the current top-K.
+    size_t k = (size_t)topK;
+    bool keepAll = k * 4 >= mc.touched.size();
+    if (keepAll) best.reserve(mc.touched.size());
+    for (int c : mc.touched) {
+        if (friends.contains(c)) continue;
+        int x = G.denseIndex(c);
+        if (filter && !filter->accepts(c, x)) continue;
+        Scored s{score(c, mc.count[x], mc.weight[x]), c, mc.count[x]};
+        if (keepAll) {
+            best.push_back(s);
+        } else if (best.size() < k) {
+            best.push_back(s);
+            std::push_heap(best.begin(), best.end(), better);
+        } else if (better(s, best.front())) {
+            std::pop_heap(best.begin(), best.end(), better);
+            best.back() = s;
+            std::push_heap(best.begin(), best.end(), better);
+        }
+    }
+    for (int c : mc.touched) {
+        int x = G.denseIndex(c);
+        mc.count[x] = 0;
+        mc.weight[x] = 0.0;
     }
+    mc.touched.clear();
 
-    return result;
+    // Step 3: Order the winners best first
+    if (keepAll) {
+        if (best.size() > k) {
+            std::nth_element(best.begin(), best.begin() + k, best.end(), better);
+            best.resize(k);
+        }
+        std::sort(best.begin(), best.end(), better);
+    } else {
+        std::sort_heap(best.begin(), best.end(), better);
+    }
+    return best;
 }
 
+inline double noWeight(int) { return 0.0; }
 
-// =============================================================
-// 2️⃣ Helper Function — Jaccard Similarity for Interests
-// =============================================================
-static double jaccardSimilarity(const std::unordered_set<std::string> &A,
-                                const std::unordered_set<std::string> &B) {
-    if (A.empty() || B.empty()) return 0.0;
+// Runs the engine with a built-in strategy
+std::vector<Scored> scoreStrategy(const CoreGraph &G, int userId, int topK, RecStrategy strategy,
+                                  const CandidateFilter *filter = nullptr) {
+    const User *user = G.getUser(userId);
+    if (!user) return {};
+    double userDegree = (double)G.degree(userId);
 
-    int common = 0;
-    for (auto &x : A) if (B.find(x) != B.end()) common++;
+    switch (strategy) {
+        case RecStrategy::Weighted:
+            return topCandidates(G, userId, topK, filter, noWeight, [&](int c, uint32_t mutual, double) {
+                const User *cand = G.getUser(c);
+                double interestSim = cand ? jaccardSimilarity(user->interests, cand->interests) : 0.0;
+                // α = 1.0 for mutual count, β = 2.0 for interest similarity
+                return (1.0 * mutual) + (2.0 * interestSim);
+            });
 
-    return (double)common / (A.size() + B.size() - common);
+        case RecStrategy::AdamicAdar:
+            // A mutual friend has degree >= 2, so log(degree) > 0
+            return topCandidates(G, userId, topK, filter,
+                [&](int f) { return 1.0 / std::log((double)std::max<size_t>(G.degree(f), 2)); },
+                [](int, uint32_t, double weight) { return weight; });
+
+        case RecStrategy::ResourceAllocation:
+            return topCandidates(G, userId, topK, filter,
+                [&](int f) { return 1.0 / (double)std::max<size_t>(G.degree(f), 1); },
+                [](int, uint32_t, double weight) { return weight; });
+
+        case RecStrategy::Jaccard:
+            return topCandidates(G, userId, topK, filter, noWeight, [&](int c, uint32_t mutual, double) {
+                return mutual / (userDegree + (double)G.degree(c) - mutual);
+            });
+
+        case RecStrategy::PreferentialAttachment:
+            return topCandidates(G, userId, topK, filter, noWeight, [&](int c, uint32_t, double) {
+                return userDegree * (double)G.degree(c);
+            });
+
+        case RecStrategy::Mutual:
+            break;
+    }
+    return topCandidates(G, userId, topK, filter, noWeight, [](int, uint32_t mutual, double) { return (double)mutual; });
+}
+
+// Mutual friends and shared interests of the winners only
+std::vector<RecCandidate> withDetails(const CoreGraph &G, int userId, const std::vector<Scored> &best) {
+    std::vector<RecCandidate> out;
+    const User *user = G.getUser(userId);
+    if (!user) return out;
+    out.reserve(best.size());
+    for (auto &s : best) {
+        const User *cand = G.getUser(s.id);
+        if (!cand) continue;
+        RecCandidate r{s.id, s.score, (int)s.mutual, G.mutualFriends(userId, s.id), {}};
+        const auto &small = user->interests.size() <= cand->interests.size() ? user->interests : cand->interests;
+        const auto &large = user->interests.size() <= cand->interests.size() ? cand->interests : user->interests;
+        for (auto &i : small)
+            if (large.count(i)) r.sharedInterests.push_back(i);
+        std::sort(r.sharedInterests.begin(), r.sharedInterests.end());
+        out.push_back(std::move(r));
+    }
+    return out;
+}
+}
+
+std::vector<RecCandidate> Recommender::recommendDetailed(int userId, int topK, RecStrategy strategy) const {
+    std::vector<RecCandidate> res;
+    if (!G || !G->getUser(userId)) return res;
+    // Candidate degrees can change without touching the user's friends
+    bool cacheable = strategy != RecStrategy::Jaccard && strategy != RecStrategy::PreferentialAttachment;
+    if (cacheable && cacheLookup(userId, topK, strategy, res)) return res;
+    uint64_t computedAt = G->modClock();
+    res = withDetails(*G, userId, scoreStrategy(*G, userId, topK, strategy));
+    if (cacheable) cacheStore(userId, topK, strategy, computedAt, res);
+    return res;
+}
+
+std::vector<RecCandidate> Recommender::recommendFiltered(int userId, int topK, RecStrategy strategy,
+                                                         const RecFilter &filter) const {
+    if (!G || !G->getUser(userId)) return {};
+    CandidateFilter prepared(*G, filter);
+    return withDetails(*G, userId, scoreStrategy(*G, userId, topK, strategy, &prepared));
+}
+
+const char *Recommender::strategyName(RecStrategy strategy) {
+    switch (strategy) {
+        case RecStrategy::Mutual: return "mutual";
+        case RecStrategy::Weighted: return "weighted";
+        case RecStrategy::AdamicAdar: return "adamic_adar";
+        case RecStrategy::ResourceAllocation: return "resource_allocation";
+        case RecStrategy::Jaccard: return "jaccard";
+        case RecStrategy::PreferentialAttachment: return "preferential_attachment";
+    }
+    return "unknown";
+}
+
+bool Recommender::parseStrategy(const std::string &name, RecStrategy &out) {
+    for (RecStrategy s : {RecStrategy::Mutual, RecStrategy::Weighted, RecStrategy::AdamicAdar,
+                          RecStrategy::ResourceAllocation, RecStrategy::Jaccard,
+                          RecStrategy::PreferentialAttachment}) {
+        if (name == strategyName(s)) {
+            out = s;
+            return true;
+        }
+    }
+    return false;
+}
+
+
+// =============================================================
+// 2️⃣ Basic Recommendation Based on Mutual Friends
+// =============================================================
+std::vector<std::pair<int,int>> Recommender::recommendByMutual(int userId, int topK) const {
+    std::vector<std::pair<int,int>> result;
+    for (auto &c : recommendDetailed(userId, topK, RecStrategy::Mutual))
+        result.push_back({c.userId, c.mutualCount});
+    return result;
 }
 
 
@@ -75,55 +291,200 @@ static double jaccardSimilarity(const std::unordered_set<std::string> &A,
 std::vector<std::pair<int,double>> Recommender::recommendWeighted(int userId, int topK,
     const std::function<double(int,int)> &weightFn) const {
 
-    std::vector<std::pair<int,double>> empty;
-    if (!G || !G->getUser(userId)) return empty;
-
-    // Step 1: Gather user’s current friends
-    std::unordered_set<int> friendsSet(G->getFriends(userId).begin(), G->getFriends(userId).end());
-
-    // Step 2: Compute mutual friend count
-    std::unordered_map<int,int> mutualCount;
-    auto adj = G->getAdjacency();
-
-    for (int f : friendsSet) {
-        auto it = adj.find(f);
-        if (it == adj.end()) continue;
-        for (int fof : it->second) {
-            if (fof == userId) continue;
-            if (friendsSet.find(fof) != friendsSet.end()) continue;
-            mutualCount[fof] += 1;
-        }
+    std::vector<std::pair<int,double>> result;
+    if (weightFn) {
+        // Custom weights are scored by the caller and never cached
+        if (!G) return result;
+        auto best = topCandidates(*G, userId, topK, nullptr, noWeight, [&](int c, uint32_t mutual, double) {
+            return weightFn(c, (int)mutual);
+        });
+        for (auto &s : best) result.push_back({s.id, s.score});
+        return result;
     }
+    for (auto &c : recommendDetailed(userId, topK, RecStrategy::Weighted))
+        result.push_back({c.userId, c.score});
+    return result;
+}
 
-    if (mutualCount.empty()) return empty;
 
-    // Step 3: Combine with interest similarity
-    const User *mainUser = G->getUser(userId);
-    std::vector<std::pair<int,double>> scored;
+// =============================================================
+// 4️⃣ Random Walk with Restart (Monte Carlo Personalized PageRank)
+// =============================================================
+std::vector<std::pair<int,double>> Recommender::recommendByRandomWalk(int userId, int topK,
+    int walks, double restart, uint32_t seed) const {
+
+    std::vector<std::pair<int,double>> empty;
+    if (!G || !G->getUser(userId) || topK <= 0) return empty;
+    walks = std::max(1, std::min(walks, 1000000));
+    if (!(restart > 0.0 && restart < 1.0)) restart = 0.15;
 
-    for (auto &p : mutualCount) {
-        int cand = p.first;
-        int mc = p.second;
+    auto snap = G->snapshot();
+    const CsrGraph &g = *snap;
+    int src = g.indexOf(userId);
+    if (src < 0 || g.degree(src) == 0) return empty;
 
-        const User *candUser = G->getUser(cand);
-        if (!candUser) continue;
+    // Step 1: Run walks in fixed batches; each batch has its own RNG stream,
+    // so results do not depend on how batches land on workers.
+    const int kMaxWalkLength = 32;
+    const size_t kBatch = 256;
+    size_t batches = ((size_t)walks + kBatch - 1) / kBatch;
+    ParallelScope scope;
+    std::vector<std::unordered_map<int,uint32_t>> visits(scope.workers());
+    std::vector<uint64_t> steps(scope.workers(), 0);
 
-        double interestSim = jaccardSimilarity(mainUser->interests, candUser->interests);
+    parallelFor(0, batches, 1, [&](size_t lo, size_t hi, unsigned worker) {
+        auto &seen = visits[worker];
+        for (size_t b = lo; b < hi; ++b) {
+            std::mt19937_64 rng(((uint64_t)seed << 32) ^ ((b + 1) * 0x9E3779B97F4A7C15ull));
+            std::uniform_real_distribution<double> coin(0.0, 1.0);
+            size_t first = b * kBatch;
+            size_t last = std::min((size_t)walks, first + kBatch);
+            for (size_t w = first; w < last; ++w) {
+                int at = src;
+                for (int len = 0; len < kMaxWalkLength; ++len) {
+                    uint32_t d = g.degree(at);
+                    if (d == 0 || coin(rng) < restart) break;
+                    at = g.begin(at)[rng() % d];
+                    ++steps[worker];
+                    if (at != src) seen[at]++;
+                }
+            }
+        }
+    });
 
-        // Weighted score formula
-        // α = 1.0 for mutual count
-        // β = 2.0 for interest similarity
-        double score = (1.0 * mc) + (2.0 * interestSim);
+    // Step 2: Merge visit counts, skipping existing friends
+    std::unordered_map<int,uint32_t> total;
+    uint64_t totalSteps = 0;
+    for (size_t w = 0; w < visits.size(); ++w) {
+        totalSteps += steps[w];
+        for (auto &p : visits[w]) total[p.first] += p.second;
+    }
+    if (totalSteps == 0) return empty;
 
-        scored.push_back({cand, score});
+    std::vector<std::pair<int,double>> scored;
+    for (auto &p : total) {
+        if (std::binary_search(g.begin(src), g.end(src), p.first)) continue;
+        scored.push_back({g.idOf(p.first), (double)p.second / (double)totalSteps});
     }
 
-    // Step 4: Sort descending by score
-    std::sort(scored.begin(), scored.end(), [](const auto &a, const auto &b) {
-        if (fabs(a.second - b.second) > 1e-9) return a.second > b.second;
+    // Step 3: Pick Top-K by visit share
+    auto better = [](const std::pair<int,double> &a, const std::pair<int,double> &b) {
+        if (a.second != b.second) return a.second > b.second;
         return a.first < b.first;
+    };
+    if ((int)scored.size() > topK) {
+        std::partial_sort(scored.begin(), scored.begin() + topK, scored.end(), better);
+        scored.resize(topK);
+    } else {
+        std::sort(scored.begin(), scored.end(), better);
+    }
+    return scored;
+}
+
+
+// =============================================================
+// 5️⃣ Batch Recommendations
+// =============================================================
+std::vector<BatchRecommendation> Recommender::recommendBatch(const std::vector<int> &userIds, int topK) const {
+    std::vector<BatchRecommendation> out(userIds.size());
+    for (size_t i = 0; i < userIds.size(); ++i) out[i].userId = userIds[i];
+    if (!G || topK <= 0 || userIds.empty()) return out;
+
+    parallelFor(0, userIds.size(), 16, [&](size_t lo, size_t hi, unsigned) {
+        for (size_t i = lo; i < hi; ++i) {
+            BatchRecommendation &r = out[i];
+            for (auto &s : scoreStrategy(*G, userIds[i], topK, RecStrategy::Weighted)) {
+                r.recs.push_back({s.id, s.score});
+                r.mutuals.push_back((int)s.mutual);
+            }
+        }
     });
+    return out;
+}
 
-    if ((int)scored.size() > topK) scored.resize(topK);
-    return scored;
+
+// =============================================================
+// 6️⃣ Result Cache (LRU + per-user modification clock)
+// =============================================================
+static uint64_t cacheKey(int userId, int topK, RecStrategy strategy) {
+    return ((uint64_t)(uint32_t)userId << 32) | ((uint64_t)(uint32_t)topK << 4) | (uint64_t)strategy;
+}
+
+bool Recommender::cacheLookup(int userId, int topK, RecStrategy s, std::vector<RecCandidate> &out) const {
+    if (!G || topK < 0 || topK >= (1 << 28)) return false;
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    if (cacheCapacity == 0) return false;
+    auto it = cacheIndex.find(cacheKey(userId, topK, s));
+    if (it == cacheIndex.end()) {
+        stats.misses++;
+        return false;
+    }
+
+    // Fresh iff the user and every friend are unchanged since computedAt
+    uint64_t at = it->second->computedAt;
+    bool fresh = G->userModified(userId) <= at;
+    if (fresh) {
+        for (int f : G->neighbors(userId)) {
+            if (G->userModified(f) > at) {
+                fresh = false;
+                break;
+            }
+        }
+    }
+    if (!fresh) {
+        lru.erase(it->second);
+        cacheIndex.erase(it);
+        stats.stale++;
+        stats.misses++;
+        return false;
+    }
+
+    lru.splice(lru.begin(), lru, it->second);
+    out = it->second->recs;
+    stats.hits++;
+    return true;
+}
+
+void Recommender::cacheStore(int userId, int topK, RecStrategy s, uint64_t computedAt,
+                             const std::vector<RecCandidate> &recs) const {
+    if (!G || topK < 0 || topK >= (1 << 28)) return;
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    if (cacheCapacity == 0) return;
+    uint64_t key = cacheKey(userId, topK, s);
+    auto it = cacheIndex.find(key);
+    if (it != cacheIndex.end()) {
+        lru.erase(it->second);
+        cacheIndex.erase(it);
+    }
+    lru.push_front(CacheEntry{key, computedAt, recs});
+    cacheIndex[key] = lru.begin();
+    while (lru.size() > cacheCapacity) {
+        cacheIndex.erase(lru.back().key);
+        lru.pop_back();
+        stats.evictions++;
+    }
+}
+
+void Recommender::setCacheCapacity(size_t entries) {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    cacheCapacity = entries;
+    while (lru.size() > cacheCapacity) {
+        cacheIndex.erase(lru.back().key);
+        lru.pop_back();
+        stats.evictions++;
+    }
+}
+
+RecommendCacheStats Recommender::cacheStats() const {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    RecommendCacheStats s = stats;
+    s.size = lru.size();
+    s.capacity = cacheCapacity;
+    return s;
+}
+
+void Recommender::clearCache() {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    lru.clear();
+    cacheIndex.clear();
 }
\ No newline at end of file
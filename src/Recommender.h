@@ -4,17 +4,79 @@
 #include <vector>
 #include <functional>
 #include <utility>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <string>
 
 /**
  * @class Recommender
  * @brief Suggests friend recommendations based on mutual connections and shared interests.
  *
- * This module implements two core recommendation strategies:
+ * This module implements three recommendation strategies:
  * 1. Mutual-friend based recommendation
  * 2. Weighted recommendation that incorporates both mutual count and interest overlap
+ * 3. Random walk with restart (personalized PageRank), which also reaches
+ *    users more than two hops away
  */
 class CoreGraph; // forward declaration
 
+/**
+ * @brief Scoring strategies of the shared candidate engine.
+ *
+ * All of them rank the same candidates (friends of friends) and are
+ * computed during the same two-hop traversal.
+ */
+enum class RecStrategy {
+    Mutual,                ///< Number of mutual friends
+    Weighted,              ///< Mutual friends + 2 * interest Jaccard similarity
+    AdamicAdar,            ///< Sum of 1 / log(degree) over mutual friends
+    ResourceAllocation,    ///< Sum of 1 / degree over mutual friends
+    Jaccard,               ///< |friends(u) ∩ friends(c)| / |friends(u) ∪ friends(c)|
+    PreferentialAttachment ///< degree(u) * degree(c)
+};
+
+/**
+ * @brief One recommended user with the evidence behind its score.
+ */
+struct RecCandidate {
+    int userId;
+    double score;
+    int mutualCount;
+    std::vector<int> mutualIds;               ///< Mutual friends (sorted)
+    std::vector<std::string> sharedInterests; ///< Interests in common (sorted)
+};
+
+/**
+ * @brief Recommendations for one user of a batch.
+ */
+struct BatchRecommendation {
+    int userId;
+    std::vector<std::pair<int, double>> recs; ///< (candidate, weighted score), best first
+    std::vector<int> mutuals;                 ///< Mutual-friend count per entry of recs
+};
+
+/**
+ * @brief Counters of the recommendation result cache.
+ */
+struct RecommendCacheStats {
+    uint64_t hits;
+    uint64_t misses;       ///< Includes stale entries that had to be recomputed
+    uint64_t stale;        ///< Entries found but invalidated by graph changes
+    uint64_t evictions;    ///< Entries dropped by the LRU bound
+    size_t size;
+    size_t capacity;
+};
+
+/**
+ * @brief Constraints applied while candidates are generated.
+ */
+struct RecFilter {
+    std::vector<int> excludedUsers;             ///< e.g. blocked users and rejected suggestions
+    std::vector<std::string> requiredInterests; ///< Candidates must have every one of them
+};
+
 class Recommender {
 public:
     /**
@@ -31,6 +93,36 @@ public:
      */
     std::vector<std::pair<int, int>> recommendByMutual(int userId, int topK = 5) const;
 
+    /**
+     * @brief Top-K candidates of a strategy with their mutual friends and
+     * shared interests, so callers do not recompute them per candidate.
+     *
+     * All strategies share one engine: mutual friends are counted over
+     * friends-of-friends in a per-thread dense array (only touched entries
+     * are reset), the best K are selected with a bounded heap or
+     * nth_element, and details are gathered for the winners only.
+     * Ties are broken by ascending user id. Results are cached except for
+     * Jaccard and PreferentialAttachment (see the result cache below).
+     */
+    std::vector<RecCandidate> recommendDetailed(int userId, int topK, RecStrategy strategy) const;
+
+    /**
+     * @brief Like recommendDetailed, but skips candidates rejected by
+     * @p filter before the top-K selection, so up to K valid results come
+     * back from a single pass. Excluded ids are held in a bitset for the
+     * query and required interests are checked against the graph's
+     * InterestIndex (case-insensitive). Filtered results are not cached.
+     */
+    std::vector<RecCandidate> recommendFiltered(int userId, int topK, RecStrategy strategy,
+                                                const RecFilter &filter) const;
+
+    /**
+     * @brief Strategy names as used by the C API: "mutual", "weighted",
+     * "adamic_adar", "resource_allocation", "jaccard", "preferential_attachment".
+     */
+    static const char *strategyName(RecStrategy strategy);
+    static bool parseStrategy(const std::string &name, RecStrategy &out);
+
     /**
      * @brief Recommends top-K users using a custom weighting function that
      * can consider mutual friends, interests, or other criteria.
@@ -55,8 +147,74 @@ public:
         const std::function<double(int, int)> &weightFn
     ) const;
 
+    /**
+     * @brief Recommends top-K users by Monte Carlo random walks with restart.
+     *
+     * Runs @p walks short walks from the user on parallel workers. Each step
+     * either restarts (probability @p restart) or moves to a random friend;
+     * walks are also cut at a fixed maximum length, so a query never does
+     * more than walks * 32 steps. Visited non-friends are ranked by visit
+     * frequency, which approximates personalized PageRank.
+     *
+     * @param walks Number of walks (clamped to [1, 1,000,000]).
+     * @return Vector of (userID, share of all visits) pairs sorted by descending score.
+     */
+    std::vector<std::pair<int, double>> recommendByRandomWalk(
+        int userId,
+        int topK,
+        int walks = 10000,
+        double restart = 0.15,
+        uint32_t seed = 42
+    ) const;
+
+    /**
+     * @brief Weighted recommendations (same scores as recommendWeighted) for
+     * many users at once.
+     *
+     * Users are processed in parallel with the same candidate engine as
+     * recommendDetailed (per-worker dense counters, bounded top-K), so
+     * memory stays O(n) per worker however large the batch is. Missing
+     * users get an empty entry. Results keep the order of @p userIds.
+     */
+    std::vector<BatchRecommendation> recommendBatch(const std::vector<int> &userIds, int topK) const;
+
+    // ----------------------------
+    // Result cache
+    // ----------------------------
+    // recommendDetailed (and so recommendByMutual / recommendWeighted
+    // without a custom weightFn) keeps results in a bounded LRU keyed by
+    // (user, k, strategy). An entry is reused only while neither the user
+    // nor any of its friends has been modified since it was computed
+    // (CoreGraph::userModified), so a change invalidates exactly the entries
+    // whose two-hop neighborhood it touches. Jaccard and
+    // PreferentialAttachment also score by the candidate's own degree, which
+    // changes outside that neighborhood, so they are never cached.
+
+    /**
+     * @brief Sets the maximum number of cached results; 0 disables the cache.
+     */
+    void setCacheCapacity(size_t entries);
+    RecommendCacheStats cacheStats() const;
+    void clearCache();
+
 private:
     const CoreGraph *G; ///< Pointer to the main user graph (read-only).
+
+    struct CacheEntry {
+        uint64_t key;
+        uint64_t computedAt; ///< CoreGraph::modClock() when computed
+        std::vector<RecCandidate> recs;
+    };
+
+    mutable std::mutex cacheMutex; // guards everything below
+    mutable std::list<CacheEntry> lru; // most recently used first
+    mutable std::unordered_map<uint64_t, std::list<CacheEntry>::iterator> cacheIndex;
+    size_t cacheCapacity;
+    mutable RecommendCacheStats stats;
+
+    bool cacheLookup(int userId, int topK, RecStrategy s, std::vector<RecCandidate> &out) const;
+    void cacheStore(int userId, int topK, RecStrategy s, uint64_t computedAt,
+                    const std::vector<RecCandidate> &recs) const;
 };
 
 #endif // RECOMMENDER_H
\ No newline at end of file
@@ -0,0 +1,243 @@
+#include "RoaringBitmap.h"
+#include <algorithm>
+#include <iterator>
+
+// =============================================================
+// 1️⃣ Containers
+// =============================================================
+RoaringBitmap::Container *RoaringBitmap::find(uint16_t key) {
+    auto it = std::lower_bound(containers.begin(), containers.end(), key,
+                               [](const Container &c, uint16_t k) { return c.key < k; });
+    return (it != containers.end() && it->key == key) ? &*it : nullptr;
+}
+
+const RoaringBitmap::Container *RoaringBitmap::find(uint16_t key) const {
+    auto it = std::lower_bound(containers.begin(), containers.end(), key,
+                               [](const Container &c, uint16_t k) { return c.key < k; });
+    return (it != containers.end() && it->key == key) ? &*it : nullptr;
+}
+
+bool RoaringBitmap::test(const Container &c, uint16_t low) {
+    if (!c.bits.empty()) return (c.bits[low >> 6] >> (low & 63)) & 1;
+    return std::binary_search(c.array.begin(), c.array.end(), low);
+}
+
+void RoaringBitmap::toBitmap(Container &c) {
+    if (!c.bits.empty()) return;
+    c.bits.assign(kWords, 0);
+    for (uint16_t low : c.array) c.bits[low >> 6] |= 1ull << (low & 63);
+    c.array.clear();
+    c.array.shrink_to_fit();
+}
+
+// Picks the smaller representation for the container's cardinality
+void RoaringBitmap::normalize(Container &c) {
+    if (c.bits.empty()) {
+        if (c.card > kArrayMax) toBitmap(c);
+        return;
+    }
+    if (c.card > kArrayMax) return;
+    c.array.clear();
+    c.array.reserve(c.card);
+    for (size_t w = 0; w < kWords; ++w) {
+        uint64_t word = c.bits[w];
+        while (word) {
+            c.array.push_back((uint16_t)(w * 64 + __builtin_ctzll(word)));
+            word &= word - 1;
+        }
+    }
+    c.bits.clear();
+    c.bits.shrink_to_fit();
+}
+
+
+// =============================================================
+// 2️⃣ Single-Element Operations
+// =============================================================
+bool RoaringBitmap::add(uint32_t x) {
+    uint16_t key = (uint16_t)(x >> 16), low = (uint16_t)x;
+    auto it = std::lower_bound(containers.begin(), containers.end(), key,
+                               [](const Container &c, uint16_t k) { return c.key < k; });
+    if (it == containers.end() || it->key != key) it = containers.insert(it, Container{key, 0, {}, {}});
+    Container &c = *it;
+
+    if (!c.bits.empty()) {
+        uint64_t &word = c.bits[low >> 6];
+        uint64_t mask = 1ull << (low & 63);
+        if (word & mask) return false;
+        word |= mask;
+    } else {
+        auto pos = std::lower_bound(c.array.begin(), c.array.end(), low);
+        if (pos != c.array.end() && *pos == low) return false;
+        c.array.insert(pos, low);
+    }
+    c.card++;
+    normalize(c);
+    return true;
+}
+
+bool RoaringBitmap::remove(uint32_t x) {
+    uint16_t key = (uint16_t)(x >> 16), low = (uint16_t)x;
+    Container *c = find(key);
+    if (!c) return false;
+
+    if (!c->bits.empty()) {
+        uint64_t &word = c->bits[low >> 6];
+        uint64_t mask = 1ull << (low & 63);
+        if (!(word & mask)) return false;
+        word &= ~mask;
+    } else {
+        auto pos = std::lower_bound(c->array.begin(), c->array.end(), low);
+        if (pos == c->array.end() || *pos != low) return false;
+        c->array.erase(pos);
+    }
+    c->card--;
+    if (c->card == 0) containers.erase(containers.begin() + (c - containers.data()));
+    else normalize(*c);
+    return true;
+}
+
+bool RoaringBitmap::contains(uint32_t x) const {
+    const Container *c = find((uint16_t)(x >> 16));
+    return c && test(*c, (uint16_t)x);
+}
+
+size_t RoaringBitmap::cardinality() const {
+    size_t n = 0;
+    for (auto &c : containers) n += c.card;
+    return n;
+}
+
+std::vector<uint32_t> RoaringBitmap::toVector() const {
+    std::vector<uint32_t> out;
+    out.reserve(cardinality());
+    forEach([&](uint32_t x) { out.push_back(x); });
+    return out;
+}
+
+size_t RoaringBitmap::memoryBytes() const {
+    size_t bytes = containers.capacity() * sizeof(Container);
+    for (auto &c : containers)
+        bytes += c.array.capacity() * sizeof(uint16_t) + c.bits.capacity() * sizeof(uint64_t);
+    return bytes;
+}
+
+
+// =============================================================
+// 3️⃣ Set Operations
+// =============================================================
+static uint32_t popcountWords(const uint64_t *w, size_t n) {
+    uint32_t card = 0;
+    for (size_t i = 0; i < n; ++i) card += (uint32_t)__builtin_popcountll(w[i]);
+    return card;
+}
+
+RoaringBitmap::Container RoaringBitmap::andOf(const Container &a, const Container &b) {
+    Container out{a.key, 0, {}, {}};
+    if (a.bits.empty() && b.bits.empty()) {
+        std::set_intersection(a.array.begin(), a.array.end(), b.array.begin(), b.array.end(),
+                              std::back_inserter(out.array));
+    } else if (a.bits.empty() || b.bits.empty()) {
+        const Container &arr = a.bits.empty() ? a : b;
+        const Container &bmp = a.bits.empty() ? b : a;
+        for (uint16_t low : arr.array)
+            if (test(bmp, low)) out.array.push_back(low);
+    } else {
+        out.bits.resize(kWords);
+        for (size_t w = 0; w < kWords; ++w) out.bits[w] = a.bits[w] & b.bits[w];
+        out.card = popcountWords(out.bits.data(), kWords);
+        normalize(out);
+        return out;
+    }
+    out.card = (uint32_t)out.array.size();
+    return out;
+}
+
+RoaringBitmap::Container RoaringBitmap::orOf(const Container &a, const Container &b) {
+    Container out{a.key, 0, {}, {}};
+    if (a.bits.empty() && b.bits.empty()) {
+        std::set_union(a.array.begin(), a.array.end(), b.array.begin(), b.array.end(),
+                       std::back_inserter(out.array));
+        out.card = (uint32_t)out.array.size();
+        normalize(out);
+        return out;
+    }
+    if (a.bits.empty() || b.bits.empty()) {
+        const Container &arr = a.bits.empty() ? a : b;
+        out.bits = (a.bits.empty() ? b : a).bits;
+        for (uint16_t low : arr.array) out.bits[low >> 6] |= 1ull << (low & 63);
+    } else {
+        out.bits.resize(kWords);
+        for (size_t w = 0; w < kWords; ++w) out.bits[w] = a.bits[w] | b.bits[w];
+    }
+    out.card = popcountWords(out.bits.data(), kWords);
+    return out;
+}
+
+RoaringBitmap::Container RoaringBitmap::andNotOf(const Container &a, const Container &b) {
+    Container out{a.key, 0, {}, {}};
+    if (a.bits.empty()) {
+        if (b.bits.empty()) {
+            std::set_difference(a.array.begin(), a.array.end(), b.array.begin(), b.array.end(),
+                                std::back_inserter(out.array));
+        } else {
+            for (uint16_t low : a.array)
+                if (!test(b, low)) out.array.push_back(low);
+        }
+        out.card = (uint32_t)out.array.size();
+        return out;
+    }
+    out.bits = a.bits;
+    if (b.bits.empty()) {
+        for (uint16_t low : b.array) out.bits[low >> 6] &= ~(1ull << (low & 63));
+    } else {
+        for (size_t w = 0; w < kWords; ++w) out.bits[w] &= ~b.bits[w];
+    }
+    out.card = popcountWords(out.bits.data(), kWords);
+    normalize(out);
+    return out;
+}
+
+RoaringBitmap RoaringBitmap::andOf(const RoaringBitmap &a, const RoaringBitmap &b) {
+    RoaringBitmap out;
+    size_t i = 0, j = 0;
+    while (i < a.containers.size() && j < b.containers.size()) {
+        const Container &ca = a.containers[i], &cb = b.containers[j];
+        if (ca.key < cb.key) { ++i; continue; }
+        if (cb.key < ca.key) { ++j; continue; }
+        Container c = andOf(ca, cb);
+        if (c.card) out.containers.push_back(std::move(c));
+        ++i; ++j;
+    }
+    return out;
+}
+
+RoaringBitmap RoaringBitmap::orOf(const RoaringBitmap &a, const RoaringBitmap &b) {
+    RoaringBitmap out;
+    size_t i = 0, j = 0;
+    while (i < a.containers.size() || j < b.containers.size()) {
+        if (j == b.containers.size() || (i < a.containers.size() && a.containers[i].key < b.containers[j].key)) {
+            out.containers.push_back(a.containers[i++]);
+        } else if (i == a.containers.size() || b.containers[j].key < a.containers[i].key) {
+            out.containers.push_back(b.containers[j++]);
+        } else {
+            out.containers.push_back(orOf(a.containers[i++], b.containers[j++]));
+        }
+    }
+    return out;
+}
+
+RoaringBitmap RoaringBitmap::andNotOf(const RoaringBitmap &a, const RoaringBitmap &b) {
+    RoaringBitmap out;
+    size_t j = 0;
+    for (const Container &ca : a.containers) {
+        while (j < b.containers.size() && b.containers[j].key < ca.key) ++j;
+        if (j == b.containers.size() || b.containers[j].key != ca.key) {
+            out.containers.push_back(ca);
+            continue;
+        }
+        Container c = andNotOf(ca, b.containers[j]);
+        if (c.card) out.containers.push_back(std::move(c));
+    }
+    return out;
+}
@@ -0,0 +1,81 @@
+#ifndef ROARING_BITMAP_H
+#define ROARING_BITMAP_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @class RoaringBitmap
+ * @brief Compressed set of 32-bit ids in the Roaring layout.
+ *
+ * Ids are split into chunks of 65536 by their high 16 bits. Each chunk is
+ * a container holding the low 16 bits, either as a sorted uint16 array
+ * (up to kArrayMax values, 2 bytes each) or as a 65536-bit bitmap (8 KB).
+ * Containers switch representation as they cross kArrayMax, so sparse
+ * sets stay small and dense sets use fixed-size word operations.
+ *
+ * Set operations work container by container. Bitmap-bitmap pairs run
+ * as plain loops over 64-bit words that the compiler vectorizes; array
+ * pairs are merged.
+ */
+class RoaringBitmap {
+public:
+    bool add(uint32_t x);             ///< false if already present
+    bool remove(uint32_t x);          ///< false if absent
+    bool contains(uint32_t x) const;
+    size_t cardinality() const;
+    bool empty() const { return containers.empty(); }
+    void clear() { containers.clear(); }
+
+    static RoaringBitmap andOf(const RoaringBitmap &a, const RoaringBitmap &b);
+    static RoaringBitmap orOf(const RoaringBitmap &a, const RoaringBitmap &b);
+    static RoaringBitmap andNotOf(const RoaringBitmap &a, const RoaringBitmap &b); ///< a \ b
+
+    /**
+     * @brief Calls fn(id) for every id in ascending order.
+     */
+    template <class Fn>
+    void forEach(Fn &&fn) const {
+        for (auto &c : containers) {
+            uint32_t high = (uint32_t)c.key << 16;
+            if (c.bits.empty()) {
+                for (uint16_t low : c.array) fn(high | low);
+                continue;
+            }
+            for (size_t w = 0; w < kWords; ++w) {
+                uint64_t word = c.bits[w];
+                while (word) {
+                    fn(high | (uint32_t)(w * 64 + __builtin_ctzll(word)));
+                    word &= word - 1;
+                }
+            }
+        }
+    }
+
+    std::vector<uint32_t> toVector() const;
+    size_t memoryBytes() const;       ///< Heap bytes held by the containers
+
+private:
+    static const size_t kArrayMax = 4096;  // beyond this a bitmap is smaller
+    static const size_t kWords = 1024;     // 65536 bits
+
+    struct Container {
+        uint16_t key;                 // high 16 bits
+        uint32_t card;
+        std::vector<uint16_t> array;  // sorted, used while bits is empty
+        std::vector<uint64_t> bits;   // kWords words once dense
+    };
+    std::vector<Container> containers; // sorted by key
+
+    Container *find(uint16_t key);
+    const Container *find(uint16_t key) const;
+    static void toBitmap(Container &c);
+    static void normalize(Container &c);
+    static bool test(const Container &c, uint16_t low);
+    static Container andOf(const Container &a, const Container &b);
+    static Container orOf(const Container &a, const Container &b);
+    static Container andNotOf(const Container &a, const Container &b);
+};
+
+#endif // ROARING_BITMAP_H
@@ -0,0 +1,138 @@
+#include "SetIntersection.h"
+#include <cstdint>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define SET_INTERSECTION_SSE2 1
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define SET_INTERSECTION_NEON 1
+#endif
+
+// Size ratio above which galloping beats a linear merge.
+static const size_t kGallopRatio = 32;
+
+// =============================================================
+// Scalar merge
+// =============================================================
+template <bool Write>
+static size_t mergeScalar(const int *a, size_t na, const int *b, size_t nb, int *out) {
+    size_t i = 0, j = 0, n = 0;
+    while (i < na && j < nb) {
+        int x = a[i], y = b[j];
+        if (x == y) {
+            if (Write) out[n] = x;
+            ++n;
+        }
+        i += (x <= y);
+        j += (y <= x);
+    }
+    return n;
+}
+
+// =============================================================
+// Galloping (small a, large b)
+// =============================================================
+template <bool Write>
+static size_t gallop(const int *a, size_t na, const int *b, size_t nb, int *out) {
+    size_t j = 0, n = 0;
+    for (size_t i = 0; i < na && j < nb; ++i) {
+        int x = a[i];
+        if (b[j] < x) {
+            // Exponential search for the first b[k] >= x, then binary search.
+            size_t step = 1;
+            while (j + step < nb && b[j + step] < x) step <<= 1;
+            size_t lo = j + (step >> 1) + 1;
+            size_t hi = (j + step < nb) ? j + step : nb;
+            while (lo < hi) {
+                size_t mid = lo + (hi - lo) / 2;
+                if (b[mid] < x) lo = mid + 1;
+                else hi = mid;
+            }
+            j = lo;
+            if (j == nb) break;
+        }
+        if (b[j] == x) {
+            if (Write) out[n] = x;
+            ++n;
+            ++j;
+        }
+    }
+    return n;
+}
+
+// =============================================================
+// SIMD block merge: compare 4 elements of a against all 4
+// rotations of a block of b, then advance the block(s) whose
+// maximum is smaller.
+// =============================================================
+#if defined(SET_INTERSECTION_SSE2) || defined(SET_INTERSECTION_NEON)
+
+// Bit k is set when a[k] occurs anywhere in b[0..3].
+static inline unsigned blockMatchMask(const int *a, const int *b) {
+#if defined(SET_INTERSECTION_SSE2)
+    __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a));
+    __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b));
+    __m128i m = _mm_cmpeq_epi32(va, vb);
+    m = _mm_or_si128(m, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1))));
+    m = _mm_or_si128(m, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2))));
+    m = _mm_or_si128(m, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(2, 1, 0, 3))));
+    return (unsigned)_mm_movemask_ps(_mm_castsi128_ps(m));
+#else
+    static const uint32_t kBits[4] = {1, 2, 4, 8};
+    int32x4_t va = vld1q_s32(a);
+    int32x4_t vb = vld1q_s32(b);
+    uint32x4_t m = vceqq_s32(va, vb);
+    m = vorrq_u32(m, vceqq_s32(va, vextq_s32(vb, vb, 1)));
+    m = vorrq_u32(m, vceqq_s32(va, vextq_s32(vb, vb, 2)));
+    m = vorrq_u32(m, vceqq_s32(va, vextq_s32(vb, vb, 3)));
+    return vaddvq_u32(vandq_u32(m, vld1q_u32(kBits)));
+#endif
+}
+
+template <bool Write>
+static size_t mergeSimd(const int *a, size_t na, const int *b, size_t nb, int *out) {
+    size_t i = 0, j = 0, n = 0;
+    while (i + 4 <= na && j + 4 <= nb) {
+        unsigned mask = blockMatchMask(a + i, b + j);
+        if (mask) {
+            if (Write) {
+                for (unsigned k = 0; k < 4; ++k)
+                    if (mask & (1u << k)) out[n++] = a[i + k];
+            } else {
+                n += (size_t)__builtin_popcount(mask);
+            }
+        }
+        int amax = a[i + 3], bmax = b[j + 3];
+        i += (amax <= bmax) ? 4 : 0;
+        j += (bmax <= amax) ? 4 : 0;
+    }
+    return n + mergeScalar<Write>(a + i, na - i, b + j, nb - j, Write ? out + n : out);
+}
+
+#endif
+
+template <bool Write>
+static size_t intersectDispatch(const int *a, size_t na, const int *b, size_t nb, int *out) {
+    if (na > nb) {
+        std::swap(a, b);
+        std::swap(na, nb);
+    }
+    if (na == 0) return 0;
+    // Disjoint ranges: nothing to do.
+    if (a[na - 1] < b[0] || b[nb - 1] < a[0]) return 0;
+    if (nb / na >= kGallopRatio) return gallop<Write>(a, na, b, nb, out);
+#if defined(SET_INTERSECTION_SSE2) || defined(SET_INTERSECTION_NEON)
+    if (na >= 8) return mergeSimd<Write>(a, na, b, nb, out);
+#endif
+    return mergeScalar<Write>(a, na, b, nb, out);
+}
+
+size_t intersectSortedCount(const int *a, size_t na, const int *b, size_t nb) {
+    return intersectDispatch<false>(a, na, b, nb, nullptr);
+}
+
+size_t intersectSorted(const int *a, size_t na, const int *b, size_t nb, int *out) {
+    return intersectDispatch<true>(a, na, b, nb, out);
+}
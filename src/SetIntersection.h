@@ -0,0 +1,28 @@
+#ifndef SET_INTERSECTION_H
+#define SET_INTERSECTION_H
+
+#include <cstddef>
+
+/**
+ * Intersection kernels over sorted, duplicate-free int arrays.
+ *
+ * Both functions pick a strategy from the input sizes:
+ *  - galloping (exponential search in the larger array) when one side is
+ *    at least 32x longer than the other,
+ *  - 4x4 SIMD block comparison (SSE2 or NEON) for similar sizes,
+ *  - a scalar merge for short tails or when no SIMD is available.
+ */
+
+/**
+ * @brief Counts the elements common to @p a and @p b.
+ */
+size_t intersectSortedCount(const int *a, size_t na, const int *b, size_t nb);
+
+/**
+ * @brief Writes the common elements to @p out in ascending order.
+ * @param out Buffer with room for min(na, nb) ints.
+ * @return Number of ints written.
+ */
+size_t intersectSorted(const int *a, size_t na, const int *b, size_t nb, int *out);
+
+#endif // SET_INTERSECTION_H
@@ -0,0 +1,161 @@
+#include "ThreadPool.h"
+
+// Index of the pool worker running on this thread (-1 for outside threads)
+static thread_local const ThreadPool *tlsPool = nullptr;
+static thread_local int tlsWorker = -1;
+static thread_local unsigned tlsPins = 0;   // Pins held by this thread
+
+ThreadPool &ThreadPool::instance() {
+    // Never destroyed: static objects elsewhere (e.g. a background index
+    // build) may still run parallel loops while the process exits.
+    static ThreadPool *pool = new ThreadPool();
+    return *pool;
+}
+
+ThreadPool::ThreadPool()
+    : numWorkers(1), nextQueue(0), pending(0), executed(0), stolen(0), stopping(false) {
+    start(0);
+}
+
+// =============================================================
+// 1️⃣ Lifecycle
+// =============================================================
+void ThreadPool::start(unsigned workers) {
+    if (workers == 0) workers = std::thread::hardware_concurrency();
+    if (workers == 0) workers = 1;
+    unsigned background = workers - 1;
+    for (unsigned i = 0; i < background; ++i) queues.emplace_back(new WorkQueue());
+    for (unsigned i = 0; i < background; ++i) threads.emplace_back(&ThreadPool::workerLoop, this, (int)i);
+    numWorkers.store(workers, std::memory_order_relaxed);
+}
+
+void ThreadPool::stop() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto &t : threads) t.join();
+    threads.clear();
+    queues.clear();
+    std::lock_guard<std::mutex> lock(sleepMutex);
+    stopping = false;
+}
+
+bool ThreadPool::resize(unsigned workers) {
+    if (tlsPins > 0 || (tlsPool == this && tlsWorker >= 0)) return false;
+    std::lock_guard<std::mutex> lock(resizeMutex);
+    std::unique_lock<std::shared_mutex> idle(lifecycle);
+    stop();
+    start(workers);
+    return true;
+}
+
+ThreadPool::Pin::Pin(ThreadPool &p) : pool(p), locked(false) {
+    bool worker = tlsPool == &pool && tlsWorker >= 0;
+    if (tlsPins == 0 && !worker) {
+        pool.lifecycle.lock_shared();
+        locked = true;
+    }
+    ++tlsPins;
+    count = pool.size();
+}
+
+ThreadPool::Pin::~Pin() {
+    --tlsPins;
+    if (locked) pool.lifecycle.unlock_shared();
+}
+
+// =============================================================
+// 2️⃣ Queues: owner works at the back, thieves take the front
+// =============================================================
+void ThreadPool::push(Task task) {
+    size_t q = (tlsPool == this && tlsWorker >= 0)
+                   ? (size_t)tlsWorker
+                   : nextQueue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+    {
+        std::lock_guard<std::mutex> lock(queues[q]->mutex);
+        queues[q]->tasks.push_back(std::move(task));
+    }
+    pending.fetch_add(1);
+    std::lock_guard<std::mutex> lock(sleepMutex);
+    wake.notify_one();
+}
+
+bool ThreadPool::popOrSteal(int self, Task &out) {
+    if (pending.load() == 0) return false;
+    if (self >= 0) {
+        WorkQueue &own = *queues[self];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            out = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            pending.fetch_sub(1);
+            return true;
+        }
+    }
+    size_t n = queues.size();
+    size_t first = self >= 0 ? (size_t)self + 1 : 0;
+    for (size_t k = 0; k < n; ++k) {
+        size_t q = (first + k) % n;
+        if ((int)q == self) continue;
+        WorkQueue &victim = *queues[q];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (victim.tasks.empty()) continue;
+        out = std::move(victim.tasks.front());
+        victim.tasks.pop_front();
+        pending.fetch_sub(1);
+        stolen.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+void ThreadPool::workerLoop(int self) {
+    tlsPool = this;
+    tlsWorker = self;
+    while (true) {
+        Task task;
+        if (popOrSteal(self, task)) {
+            task();
+            executed.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wake.wait(lock, [this]() { return pending.load() > 0 || stopping; });
+        if (stopping && pending.load() == 0) break;
+    }
+    tlsPool = nullptr;
+    tlsWorker = -1;
+}
+
+bool ThreadPool::runOne() {
+    Task task;
+    if (!popOrSteal(tlsPool == this ? tlsWorker : -1, task)) return false;
+    task();
+    executed.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+// =============================================================
+// 3️⃣ Fork-join
+// =============================================================
+void ThreadPool::runReplicated(unsigned copies, const Task &body) {
+    if (copies == 0) return;
+    if (copies == 1 || queues.empty()) {
+        for (unsigned i = 0; i < copies; ++i) body();
+        return;
+    }
+    std::atomic<unsigned> done(0);
+    for (unsigned i = 1; i < copies; ++i) {
+        push([&body, &done]() {
+            body();
+            done.fetch_add(1, std::memory_order_release);
+        });
+    }
+    body();
+    // Help instead of blocking: the remaining copies may sit in our own deque.
+    while (done.load(std::memory_order_acquire) < copies - 1) {
+        if (!runOne()) std::this_thread::yield();
+    }
+}
@@ -0,0 +1,118 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @class ThreadPool
+ * @brief The library's single work-stealing task scheduler.
+ *
+ * Each worker owns a deque: it pushes and pops its own tasks at the back
+ * (LIFO, cache-warm) and idle workers steal from the front of other
+ * deques. Threads that wait for tasks (including the caller of a parallel
+ * loop) help by running queued tasks instead of blocking, so nested
+ * parallel loops cannot deadlock.
+ *
+ * Algorithms do not use this class directly; they go through parallelFor /
+ * parallelReduce in Parallel.h.
+ */
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+
+    /**
+     * @brief The process-wide pool, started on first use with
+     * hardware_concurrency() - 1 background threads.
+     */
+    static ThreadPool &instance();
+
+    /**
+     * @brief Total workers including the calling thread (>= 1).
+     */
+    unsigned size() const { return numWorkers.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Restarts the pool with @p workers workers (0 = hardware default).
+     * Waits until no Pin is held, so running loops finish on the old pool.
+     * @return false (and does nothing) when called from inside a Pin or a
+     * pool task, where waiting would deadlock.
+     */
+    bool resize(unsigned workers);
+
+    /**
+     * @brief Holds the pool at its current size while alive.
+     *
+     * The outermost Pin on a thread takes a shared lock that resize()
+     * waits for; nested Pins and pool workers (which only run tasks of a
+     * pinned loop) do not lock again. Code that sizes per-worker scratch
+     * takes a Pin first so workers() matches the loop's worker indices.
+     */
+    class Pin {
+    public:
+        explicit Pin(ThreadPool &pool);
+        ~Pin();
+        Pin(const Pin &) = delete;
+        Pin &operator=(const Pin &) = delete;
+        unsigned workers() const { return count; }
+
+    private:
+        ThreadPool &pool;
+        bool locked;
+        unsigned count;
+    };
+
+    /**
+     * @brief Runs @p body on @p copies workers at once (the caller is one of
+     * them) and returns when every copy has finished.
+     */
+    void runReplicated(unsigned copies, const Task &body);
+
+    /**
+     * @brief Runs one queued task on the calling thread, if any.
+     * @return false when every deque was empty.
+     */
+    bool runOne();
+
+    uint64_t tasksExecuted() const { return executed.load(std::memory_order_relaxed); }
+    uint64_t tasksStolen() const { return stolen.load(std::memory_order_relaxed); }
+
+private:
+    ThreadPool();
+    ~ThreadPool() = delete;  // lives until process exit; see instance()
+
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<WorkQueue>> queues;  // one per background thread
+    std::vector<std::thread> threads;
+    std::atomic<unsigned> numWorkers;
+    std::atomic<unsigned> nextQueue;   // round-robin target for outside pushes
+    std::atomic<size_t> pending;       // queued, not yet started
+    std::atomic<uint64_t> executed, stolen;
+
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+    bool stopping;
+
+    std::mutex resizeMutex;
+    std::shared_mutex lifecycle;       // shared by outermost Pins, exclusive in resize()
+
+    void start(unsigned workers);
+    void stop();
+    void push(Task task);
+    bool popOrSteal(int self, Task &out);
+    void workerLoop(int self);
+};
+
+#endif // THREAD_POOL_H
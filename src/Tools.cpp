@@ -1,7 +1,10 @@
 #include "Tools.h"
 #include "CoreGraph.h"
+#include "MemoryReport.h"
 #include <fstream>
 #include <algorithm>
+#include <sstream>
+#include <iomanip>
 
 Tools::Tools(CoreGraph *graph) : root(nullptr), G(graph) {
     root = new TrieNode();
@@ -18,7 +21,7 @@ void Tools::freeTrie(TrieNode *n) {
     delete n;
 }
 
-void Tools::insertUsername(const std::string &name, int userId) {
+void Tools::insertUsername(std::string_view name, int userId) {
     TrieNode *cur = root;
     for (char c : name) {
         if (!cur->next.count(c)) cur->next[c] = new TrieNode();
@@ -26,7 +29,6 @@ void Tools::insertUsername(const std::string &name, int userId) {
         cur->ids.push_back(userId);
     }
     cur->end = true;
-    idToName[userId] = name;
 }
 
 std::vector<int> Tools::suggestByPrefix(const std::string &prefix, int k) {
@@ -40,8 +42,12 @@ std::vector<int> Tools::suggestByPrefix(const std::string &prefix, int k) {
     std::unordered_set<int> seen;
     for (int id : cur->ids) seen.insert(id);
     std::vector<int> candidates(seen.begin(), seen.end());
+    auto nameOf = [&](int id) {
+        const User *u = G ? G->getUser(id) : nullptr;
+        return u ? u->name : std::string_view();
+    };
     std::sort(candidates.begin(), candidates.end(), [&](int a, int b){
-        return idToName[a] < idToName[b];
+        return nameOf(a) < nameOf(b);
     });
     if ((int)candidates.size() > k) candidates.resize(k);
     return candidates;
@@ -55,15 +61,13 @@ bool Tools::exportToDot(const std::string &filename) {
     for (int id : G->listAllUsers()) {
         const User* u = G->getUser(id);
         if (!u) continue;
-        std::string label = u->name;
+        std::string label(u->name);
         // escape quotes
         for (char &c : label) if (c == '"') c = '\'';
         ofs << "  " << id << " [label=\"" << label << "\"];\n";
     }
-    auto adj = G->getAdjacency();
-    for (auto &kv : adj) {
-        int u = kv.first;
-        for (int v : kv.second) {
+    for (int u : G->listAllUsers()) {
+        for (int v : G->neighbors(u)) {
             if (u < v) ofs << "  " << u << " -- " << v << ";\n";
         }
     }
@@ -75,7 +79,6 @@ bool Tools::exportToDot(const std::string &filename) {
 void Tools::rebuildTrieFromGraph() {
     freeTrie(root);
     root = new TrieNode();
-    idToName.clear();
     if (!G) return;
     for (int id : G->listAllUsers()) {
         const User* u = G->getUser(id);
@@ -83,3 +86,41 @@ void Tools::rebuildTrieFromGraph() {
         insertUsername(u->name, id);
     }
 }
+
+
+void Tools::measureTrie(const TrieNode *n, size_t &nodes, size_t &bytes, size_t &internal,
+                        size_t &children, size_t &ids) const {
+    if (!n) return;
+    nodes++;
+    bytes += MemoryReport::heapBlock(sizeof(TrieNode));
+    bytes += MemoryReport::tableBytes(n->next);
+    bytes += MemoryReport::vectorBytes(n->ids);
+    ids += n->ids.size();
+    if (!n->next.empty()) {
+        internal++;
+        children += n->next.size();
+    }
+    for (auto &p : n->next) measureTrie(p.second, nodes, bytes, internal, children, ids);
+}
+
+void Tools::reportMemory(MemoryReport &report) const {
+    size_t nodes = 0, bytes = 0, internal = 0, children = 0, ids = 0;
+    measureTrie(root, nodes, bytes, internal, children, ids);
+    report.add("tools.trie", bytes, nodes);
+
+    // Long single-child chains pay a whole hash map per character.
+    double fanout = internal ? (double)children / (double)internal : 0.0;
+    if (nodes > 1000 && fanout < 1.5) {
+        std::ostringstream oss;
+        oss << "tools.trie: average fan-out " << std::fixed << std::setprecision(2) << fanout
+            << " over " << nodes << " nodes; per-node hash maps dominate (" << bytes << " bytes)";
+        report.warn(oss.str());
+    }
+    size_t names = G ? G->userIds().size() : 0;
+    if (names > 0 && ids > 8 * names) {
+        std::ostringstream oss;
+        oss << "tools.trie: " << ids << " prefix id entries for " << names
+            << " names (every node repeats the ids below it)";
+        report.warn(oss.str());
+    }
+}
@@ -2,10 +2,12 @@
 #define TOOLS_H
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <unordered_map>
 
 class CoreGraph;
+class MemoryReport;
 
 class Tools {
 public:
@@ -13,7 +15,7 @@ public:
     ~Tools();
 
     // Trie-based autocomplete
-    void insertUsername(const std::string &name, int userId);
+    void insertUsername(std::string_view name, int userId);
     std::vector<int> suggestByPrefix(const std::string &prefix, int k=5);
 
     // Export to Graphviz DOT
@@ -22,6 +24,9 @@ public:
     // Rebuild trie from current graph
     void rebuildTrieFromGraph();
 
+    // Bytes held by the trie; warns about sparse trie fan-out
+    void reportMemory(MemoryReport &report) const;
+
 private:
     struct TrieNode {
         std::unordered_map<char, TrieNode*> next;
@@ -30,9 +35,10 @@ private:
         TrieNode(): end(false) {}
     };
     TrieNode *root;
-    CoreGraph *G;
-    std::unordered_map<int,std::string> idToName;
+    CoreGraph *G;  // names for ranking suggestions come from G->getUser(id)->name
     void freeTrie(TrieNode *n);
+    void measureTrie(const TrieNode *n, size_t &nodes, size_t &bytes, size_t &internal,
+                     size_t &children, size_t &ids) const;
 };
 
 #endif // TOOLS_H
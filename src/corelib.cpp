@@ -6,13 +6,25 @@
 #include "Recommender.h"
 #include "Tools.h"
 #include "GraphAlgorithms.h"
+#include "ApiStats.h"
+#include "MemoryReport.h"
+#include "JsonEscape.h"
+#include "DistanceOracle.h"
+#include "Parallel.h"
+#include "JobManager.h"
+#include "CsrGraph.h"
+#include "CompressedCsr.h"
+#include "ChangeFeed.h"
 
 #include <string>
+#include <string_view>
 #include <sstream>
 #include <vector>
 #include <algorithm>
 #include <cstring>
+#include <cstdlib>
 #include <iostream>
+#include <unordered_map>
 
 // Single global objects (one graph in memory)
 static CoreGraph G;
@@ -20,6 +32,19 @@ static Persistence P(&G);
 static Recommender R(&G);
 static Tools T(&G);
 static GraphAlgorithms A(&G);
+static DistanceOracle D(&G);
+static JobManager J;
+static ChangeFeed F;  // mutations made through this API, for _api_changes_since
+
+// Open batch recommendation cursors (see _api_recommend_batch_begin)
+struct BatchCursor {
+    std::vector<int> users;
+    size_t pos;
+    int topK;
+    int chunk;
+};
+static std::unordered_map<int, BatchCursor> batchCursors;
+static int nextBatchCursor = 1;
 
 // helper to strdup string for C ABI
 static char* cstrdup(const std::string &s) {
@@ -30,90 +55,259 @@ static char* cstrdup(const std::string &s) {
     return p;
 }
 
-// JSON helpers (very small helpers - build strings manually)
-static std::string json_escape(const std::string &in) {
-    std::string out;
-    out.reserve(in.size() + 10);
-    for (char c : in) {
-        switch (c) {
-            case '\"': out += "\\\""; break;
-            case '\\': out += "\\\\"; break;
-            case '\b': out += "\\b"; break;
-            case '\f': out += "\\f"; break;
-            case '\n': out += "\\n"; break;
-            case '\r': out += "\\r"; break;
-            case '\t': out += "\\t"; break;
-            default: out.push_back(c);
-        }
+// Comma-separated items with surrounding spaces trimmed; empty items are skipped
+static std::vector<std::string> splitCsv(const char* csv) {
+    std::vector<std::string> out;
+    if (!csv) return out;
+    std::stringstream ss(csv);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        size_t b = item.find_first_not_of(" \t");
+        if (b == std::string::npos) continue;
+        size_t e = item.find_last_not_of(" \t");
+        out.push_back(item.substr(b, e-b+1));
     }
     return out;
 }
 
-// ---------------- basic ops ----------------
+// Comma-separated ids; false if any item is not an integer
+static bool parseIdCsv(const char* csv, std::vector<int> &out) {
+    for (auto &item : splitCsv(csv)) {
+        char *end = nullptr;
+        long id = std::strtol(item.c_str(), &end, 10);
+        if (!end || *end != '\0') return false;
+        out.push_back((int)id);
+    }
+    return true;
+}
+
+// ---------------- background job kinds ----------------
+// Each kind reads only the snapshot in its context, never the globals above.
+static void writeIdLists(std::ostringstream &oss, const std::vector<std::vector<int>> &lists, int minSize) {
+    oss << "[";
+    bool first = true;
+    for (auto &l : lists) {
+        if ((int)l.size() < minSize) continue;
+        if (!first) oss << ",";
+        oss << "[";
+        for (size_t j = 0; j < l.size(); ++j) {
+            if (j) oss << ",";
+            oss << l[j];
+        }
+        oss << "]";
+        first = false;
+    }
+    oss << "]";
+}
+
+static std::string jobComponents(const JobContext &ctx) {
+    auto comps = GraphAlgorithms::componentsOf(ctx.graph);
+    if (ctx.cancelled()) return "";
+    std::ostringstream oss;
+    oss << "{\"count\":" << comps.size() << ",\"components\":";
+    writeIdLists(oss, comps, ctx.intParam("min_size", 1));
+    oss << "}";
+    return oss.str();
+}
+
+static std::string jobCommunities(const JobContext &ctx) {
+    CommunityResult res = GraphAlgorithms::communitiesOf(ctx.graph, nullptr, &ctx.cancelRequested);
+    if (ctx.cancelled()) return "";
+    std::ostringstream oss;
+    oss << "{\"modularity\":" << res.modularity << ",\"levels\":" << res.levels;
+    oss << ",\"count\":" << res.communities.size() << ",\"communities\":";
+    writeIdLists(oss, res.communities, ctx.intParam("min_size", 1));
+    oss << "}";
+    return oss.str();
+}
+
+static std::string jobPageRank(const JobContext &ctx) {
+    int iterations = 0;
+    double residual = 0.0;
+    double damping = ctx.doubleParam("damping", 0.85);
+    if (damping < 0.0 || damping >= 1.0) damping = 0.85;
+    auto scores = GraphAlgorithms::pageRankOf(ctx.graph, damping, 1e-6, 100, &iterations, &residual,
+                                              &ctx.cancelRequested);
+    if (ctx.cancelled()) return "";
+    auto top = GraphAlgorithms::topScored(ctx.graph, scores, ctx.intParam("top", 10));
+    std::ostringstream oss;
+    oss << "{\"iterations\":" << iterations << ",\"residual\":" << residual << ",\"top\":[";
+    for (size_t i = 0; i < top.size(); ++i) {
+        if (i) oss << ",";
+        oss << "{\"id\":" << top[i].first << ",\"score\":" << top[i].second << "}";
+    }
+    oss << "]}";
+    return oss.str();
+}
+
+static std::string jobTriangles(const JobContext &ctx) {
+    TriangleStats st = GraphAlgorithms::triangleStatsOf(ctx.graph);
+    if (ctx.cancelled()) return "";
+    std::ostringstream oss;
+    oss << "{\"triangles\":" << st.triangles << ",\"wedges\":" << st.wedges;
+    oss << ",\"transitivity\":" << st.transitivity << "}";
+    return oss.str();
+}
+
+static std::string jobBetweenness(const JobContext &ctx) {
+    auto top = GraphAlgorithms::betweennessOf(ctx.graph, ctx.intParam("samples", 64),
+                                              ctx.intParam("top", 10), (uint32_t)ctx.intParam("seed", 42),
+                                              &ctx.cancelRequested);
+    if (ctx.cancelled()) return "";
+    std::ostringstream oss;
+    oss << "[";
+    for (size_t i = 0; i < top.size(); ++i) {
+        if (i) oss << ",";
+        oss << "{\"id\":" << top[i].userId << ",\"score\":" << top[i].score;
+        oss << ",\"error\":" << top[i].error << ",\"normalized\":" << top[i].normalized << "}";
+    }
+    oss << "]";
+    return oss.str();
+}
+
+static std::string jobCores(const JobContext &ctx) {
+    auto core = GraphAlgorithms::coreNumbersOf(ctx.graph);
+    if (ctx.cancelled()) return "";
+    int maxCore = 0;
+    for (int c : core) maxCore = std::max(maxCore, c);
+    std::vector<size_t> histogram(maxCore + 1, 0);
+    for (int c : core) histogram[c]++;
+    std::ostringstream oss;
+    oss << "{\"maxCore\":" << maxCore << ",\"histogram\":[";
+    for (size_t k = 0; k < histogram.size(); ++k) {
+        if (k) oss << ",";
+        oss << histogram[k];
+    }
+    oss << "]";
+    int k = ctx.intParam("k", -1);
+    if (k >= 0) {
+        oss << ",\"members\":[";
+        bool first = true;
+        for (size_t u = 0; u < core.size(); ++u) {
+            if (core[u] < k) continue;
+            if (!first) oss << ",";
+            oss << ctx.graph.idOf((int)u);
+            first = false;
+        }
+        oss << "]";
+    }
+    oss << "}";
+    return oss.str();
+}
+
+static void registerJobKinds() {
+    J.registerKind("components", jobComponents);
+    J.registerKind("communities", jobCommunities);
+    J.registerKind("pagerank", jobPageRank);
+    J.registerKind("triangles", jobTriangles);
+    J.registerKind("betweenness", jobBetweenness);
+    J.registerKind("kcore", jobCores);
+}
+
 extern "C" {
 
 // NOTE: exported names use the underscore prefix to match Python loader
 
+// ---------------- basic ops ----------------
 int _api_add_user(const char* name) {
-    if (!name) return -1;
+    ApiCall call(ApiFn::AddUser);
+    if (!name) return call.check(-1);
     std::string sname(name);
     int id = G.addUser(sname);
+    F.record(ChangeType::AddUser, id);
     // keep tools and persistence indices updated
     P.rebuildNameIndex();
     T.insertUsername(sname, id);
-    return id;
+    A.onUserAdded(id);
+    D.maybeRebuild();
+    return call.check(id);
 }
 
 int _api_add_user_with_id(const char* name, int fixedId) {
-    if (!name) return -1;
+    ApiCall call(ApiFn::AddUserWithId);
+    if (!name) return call.check(-1);
     std::string sname(name);
     if (G.addUser(sname, fixedId)) {
+        F.record(ChangeType::AddUser, fixedId);
         P.rebuildNameIndex();
         T.insertUsername(sname, fixedId);
+        A.onUserAdded(fixedId);
+        D.maybeRebuild();
         return fixedId;
     }
-    return -1;
+    return call.check(-1);
 }
 
 bool _api_add_friend(int a, int b) {
-    return G.addFriend(a, b);
+    ApiCall call(ApiFn::AddFriend);
+    bool ok = G.addFriend(a, b);
+    if (ok) {
+        F.record(ChangeType::AddFriend, a, b);
+        A.onFriendAdded(a, b);
+        D.maybeRebuild();
+    }
+    return call.check(ok);
 }
 
 bool _api_remove_friend(int a, int b) {
-    return G.removeFriend(a, b);
+    ApiCall call(ApiFn::RemoveFriend);
+    bool ok = G.removeFriend(a, b);
+    if (ok) {
+        F.record(ChangeType::RemoveFriend, a, b);
+        A.onFriendRemoved(a, b);
+        D.maybeRebuild();
+    }
+    return call.check(ok);
+}
+
+// pairs holds pairCount (a, b) pairs back to back
+int _api_add_friends_bulk(const int* pairs, int pairCount) {
+    ApiCall call(ApiFn::AddFriendsBulk);
+    if (!pairs || pairCount < 0) return call.check(-1);
+    std::vector<std::pair<int,int>> edges((size_t)pairCount);
+    for (int i = 0; i < pairCount; ++i) edges[i] = {pairs[2 * i], pairs[2 * i + 1]};
+
+    auto inserted = G.addFriendsBulk(edges);
+    for (auto &e : inserted) F.record(ChangeType::AddFriend, e.first, e.second);
+    // Cores are recomputed on their next query; the oracle counts every new edge
+    if (!inserted.empty()) D.maybeRebuild();
+    return call.check((int)inserted.size());
 }
 
 bool _api_remove_user(int id) {
+    ApiCall call(ApiFn::RemoveUser);
     bool ok = G.removeUser(id);
     if (ok) {
+        F.record(ChangeType::RemoveUser, id);
         P.rebuildNameIndex();
         T.rebuildTrieFromGraph();
+        D.maybeRebuild();
     }
-    return ok;
+    return call.check(ok);
 }
 
 // ---------------- interests ----------------
 bool _api_add_interests(int id, const char* csv) {
-    if (!csv) return false;
-    // split by comma
-    std::string s(csv);
-    std::stringstream ss(s);
-    std::string item;
-    std::vector<std::string> arr;
-    while (std::getline(ss, item, ',')) {
-        // trim spaces
-        size_t b = item.find_first_not_of(" \t");
-        if (b == std::string::npos) continue;
-        size_t e = item.find_last_not_of(" \t");
-        std::string it = item.substr(b, e-b+1);
-        G.addInterest(id, it);
+    ApiCall call(ApiFn::AddInterests);
+    if (!csv) return call.check(false);
+    // A missing user counts as a failed call but still returns true, as
+    // /api/add_interests callers expect; there is nothing to record
+    const User *user = G.getUser(id);
+    if (!user) {
+        call.fail();
+        return true;
     }
+    size_t before = user->interests.size();
+    for (auto &it : splitCsv(csv)) G.addInterest(id, it);
+    // Repeated interests change nothing and are not worth an event
+    if (user->interests.size() != before) F.record(ChangeType::Interests, id);
     return true;
 }
 
 char* _api_get_user_interests(int id) {
+    ApiCall call(ApiFn::GetUserInterests);
     const User* u = G.getUser(id);
-    if (!u) return cstrdup("null");
+    if (!u) { call.fail(); return cstrdup("null"); }
     std::string out = "[";
     bool first = true;
     for (auto &i : u->interests) {
@@ -128,6 +322,7 @@ char* _api_get_user_interests(int id) {
 // ---------------- queries / algorithms ----------------
 
 char* _api_list_all_users() {
+    ApiCall call(ApiFn::ListAllUsers);
     auto ids = G.listAllUsers();
     std::ostringstream oss;
     oss << "[";
@@ -147,8 +342,9 @@ char* _api_list_all_users() {
 }
 
 char* _api_print_user_info(int id) {
+    ApiCall call(ApiFn::PrintUserInfo);
     const User* u = G.getUser(id);
-    if (!u) return cstrdup("null");
+    if (!u) { call.fail(); return cstrdup("null"); }
     std::ostringstream oss;
     oss << "{";
     oss << "\"id\":" << u->id << ",";
@@ -175,6 +371,8 @@ char* _api_print_user_info(int id) {
 }
 
 char* _api_recommend_mutual(int userId, int topK) {
+    ApiCall call(ApiFn::RecommendMutual);
+    if (!G.userExists(userId)) call.fail();
     std::ostringstream oss;
     auto recs = R.recommendByMutual(userId, topK);
     oss << "[";
@@ -196,41 +394,79 @@ char* _api_recommend_mutual(int userId, int topK) {
     return cstrdup(oss.str());
 }
 
+// Candidates with their score, mutual count and shared interests
+static std::string candidatesJson(const std::vector<RecCandidate> &recs) {
+    std::ostringstream oss;
+    oss << "[";
+    bool first = true;
+    for (auto &c : recs) {
+        const User* u = G.getUser(c.userId);
+        if (!u) continue;
+        if (!first) oss << ",";
+        oss << "{";
+        oss << "\"id\":" << c.userId << ",";
+        oss << "\"name\":\"" << json_escape(u->name) << "\",";
+        oss << "\"score\":" << c.score << ",";
+        oss << "\"mutuals\":" << c.mutualCount << ",";
+        oss << "\"shared_interests\":[";
+        for (size_t i = 0; i < c.sharedInterests.size(); ++i) {
+            if (i) oss << ",";
+            oss << "\"" << json_escape(c.sharedInterests[i]) << "\"";
+        }
+        oss << "]";
+        oss << "}";
+        first = false;
+    }
+    oss << "]";
+    return oss.str();
+}
+
 char* _api_recommend_weighted(int userId, int topK) {
+    ApiCall call(ApiFn::RecommendWeighted);
+    if (!G.userExists(userId)) call.fail();
+    return cstrdup(candidatesJson(R.recommendDetailed(userId, topK, RecStrategy::Weighted)));
+}
+
+char* _api_recommend_scored(int userId, int topK, const char* strategy) {
+    ApiCall call(ApiFn::RecommendScored);
+    RecStrategy s;
+    if (!strategy || !Recommender::parseStrategy(strategy, s)) { call.fail(); return cstrdup("[]"); }
+    if (!G.userExists(userId)) call.fail();
+    return cstrdup(candidatesJson(R.recommendDetailed(userId, topK, s)));
+}
+
+char* _api_recommend_filtered(int userId, int topK, const char* strategy,
+                              const char* excludeCsv, const char* interestsCsv) {
+    ApiCall call(ApiFn::RecommendFiltered);
+    RecStrategy s;
+    RecFilter filter;
+    if (!strategy || !Recommender::parseStrategy(strategy, s) || !parseIdCsv(excludeCsv, filter.excludedUsers)) {
+        call.fail();
+        return cstrdup("[]");
+    }
+    filter.requiredInterests = splitCsv(interestsCsv);
+    if (!G.userExists(userId)) call.fail();
+    return cstrdup(candidatesJson(R.recommendFiltered(userId, topK, s, filter)));
+}
+
+char* _api_recommend_random_walk(int userId, int topK, int walks) {
+    ApiCall call(ApiFn::RecommendRandomWalk);
+    if (!G.userExists(userId)) call.fail();
     std::ostringstream oss;
-    auto recs = R.recommendWeighted(userId, topK, nullptr);
-    const User* target = G.getUser(userId);
+    auto recs = walks > 0 ? R.recommendByRandomWalk(userId, topK, walks)
+                          : R.recommendByRandomWalk(userId, topK);
     oss << "[";
     bool first = true;
     for (auto &p : recs) {
         int cand = p.first;
-        double score = p.second;
         const User* u = G.getUser(cand);
         if (!u) continue;
         if (!first) oss << ",";
         oss << "{";
         oss << "\"id\":" << cand << ",";
         oss << "\"name\":\"" << json_escape(u->name) << "\",";
-        oss << "\"score\":" << score << ",";
-        // mutuals
-        auto f1 = G.getFriends(userId);
-        auto f2 = G.getFriends(cand);
-        int mutuals = 0;
-        for (int a : f1) for (int b : f2) if (a == b) ++mutuals;
-        oss << "\"mutuals\":" << mutuals << ",";
-        // shared interests
-        oss << "\"shared_interests\":[";
-        bool firstI = true;
-        if (target) {
-            for (auto &it: target->interests) {
-                if (u->interests.count(it)) {
-                    if (!firstI) oss << ",";
-                    oss << "\"" << json_escape(it) << "\"";
-                    firstI = false;
-                }
-            }
-        }
-        oss << "]";
+        oss << "\"score\":" << p.second << ",";
+        oss << "\"mutuals\":" << A.mutualCount(userId, cand);
         oss << "}";
         first = false;
     }
@@ -238,8 +474,89 @@ char* _api_recommend_weighted(int userId, int topK) {
     return cstrdup(oss.str());
 }
 
+char* _api_recommend_cache_stats() {
+    ApiCall call(ApiFn::RecommendCacheStats);
+    RecommendCacheStats s = R.cacheStats();
+    uint64_t lookups = s.hits + s.misses;
+    std::ostringstream oss;
+    oss << "{";
+    oss << "\"hits\":" << s.hits << ",";
+    oss << "\"misses\":" << s.misses << ",";
+    oss << "\"stale\":" << s.stale << ",";
+    oss << "\"evictions\":" << s.evictions << ",";
+    oss << "\"hit_rate\":" << (lookups ? (double)s.hits / (double)lookups : 0.0) << ",";
+    oss << "\"size\":" << s.size << ",";
+    oss << "\"capacity\":" << s.capacity;
+    oss << "}";
+    return cstrdup(oss.str());
+}
+
+bool _api_recommend_cache_capacity(int entries) {
+    ApiCall call(ApiFn::RecommendCacheCapacity);
+    if (entries < 0) return call.check(false);
+    R.setCacheCapacity((size_t)entries);
+    return true;
+}
+
+// Batch recommendations are streamed: begin() fixes the user list, each
+// next() computes and returns one chunk, end() releases the cursor.
+int _api_recommend_batch_begin(const char* userIdsCsv, int topK, int chunkSize) {
+    ApiCall call(ApiFn::RecommendBatchBegin);
+    if (topK <= 0) return call.check(-1);
+    BatchCursor cur;
+    cur.pos = 0;
+    cur.topK = topK;
+    cur.chunk = chunkSize > 0 ? chunkSize : 1000;
+    if (!userIdsCsv || !*userIdsCsv) {
+        cur.users = G.listAllUsers();
+    } else if (!parseIdCsv(userIdsCsv, cur.users)) {
+        return call.check(-1);
+    }
+    int id = nextBatchCursor++;
+    batchCursors[id] = std::move(cur);
+    return id;
+}
+
+char* _api_recommend_batch_next(int cursor) {
+    ApiCall call(ApiFn::RecommendBatchNext);
+    auto it = batchCursors.find(cursor);
+    if (it == batchCursors.end()) {
+        call.fail();
+        return cstrdup("[]");
+    }
+    BatchCursor &cur = it->second;
+    size_t end = std::min(cur.users.size(), cur.pos + (size_t)cur.chunk);
+    std::vector<int> ids(cur.users.begin() + cur.pos, cur.users.begin() + end);
+    cur.pos = end;
+
+    auto results = R.recommendBatch(ids, cur.topK);
+    std::ostringstream oss;
+    oss << "[";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BatchRecommendation &r = results[i];
+        if (i) oss << ",";
+        oss << "{\"id\":" << r.userId << ",\"recommendations\":[";
+        for (size_t j = 0; j < r.recs.size(); ++j) {
+            if (j) oss << ",";
+            oss << "{\"id\":" << r.recs[j].first;
+            oss << ",\"score\":" << r.recs[j].second;
+            oss << ",\"mutuals\":" << r.mutuals[j] << "}";
+        }
+        oss << "]}";
+    }
+    oss << "]";
+    return cstrdup(oss.str());
+}
+
+bool _api_recommend_batch_end(int cursor) {
+    ApiCall call(ApiFn::RecommendBatchEnd);
+    return call.check(batchCursors.erase(cursor) > 0);
+}
+
 char* _api_shortest_path(int src, int dst) {
+    ApiCall call(ApiFn::ShortestPath);
     auto path = A.shortestPath(src, dst);
+    if (path.empty()) call.fail();
     std::ostringstream oss;
     oss << "{ \"path\": [";
     for (size_t i=0;i<path.size();++i) {
@@ -251,6 +568,7 @@ char* _api_shortest_path(int src, int dst) {
 }
 
 char* _api_connected_components() {
+    ApiCall call(ApiFn::ConnectedComponents);
     auto comps = A.connectedComponents();
     std::ostringstream oss;
     oss << "[";
@@ -268,7 +586,8 @@ char* _api_connected_components() {
 }
 
 char* _api_suggest_prefix(const char* prefix, int k) {
-    if (!prefix) return cstrdup("[]");
+    ApiCall call(ApiFn::SuggestPrefix);
+    if (!prefix) { call.fail(); return cstrdup("[]"); }
     auto v = T.suggestByPrefix(std::string(prefix), k);
     std::ostringstream oss;
     oss << "[";
@@ -287,20 +606,361 @@ char* _api_suggest_prefix(const char* prefix, int k) {
     return cstrdup(oss.str());
 }
 
+// ---------------- interest search ----------------
+// Users with every interest in allCsv, at least one in anyCsv (if given)
+// and none in noneCsv, highest degree first.
+char* _api_search_interests(const char* allCsv, const char* anyCsv, const char* noneCsv, int topK) {
+    ApiCall call(ApiFn::SearchInterests);
+    InterestQuery q{splitCsv(allCsv), splitCsv(anyCsv), splitCsv(noneCsv)};
+    size_t matches = 0;
+    auto ids = G.searchInterests(q, topK, &matches);
+    std::ostringstream oss;
+    oss << "{\"matches\":" << matches << ",\"users\":[";
+    bool first = true;
+    for (int id : ids) {
+        const User* u = G.getUser(id);
+        if (!u) continue;
+        if (!first) oss << ",";
+        oss << "{";
+        oss << "\"id\":" << id << ",";
+        oss << "\"name\":\"" << json_escape(u->name) << "\",";
+        oss << "\"degree\":" << G.degree(id);
+        oss << "}";
+        first = false;
+    }
+    oss << "]}";
+    return cstrdup(oss.str());
+}
+
+// ---------------- triangles / clustering ----------------
+char* _api_triangle_stats(int sampleWedges) {
+    ApiCall call(ApiFn::TriangleStats);
+    TriangleStats st = sampleWedges > 0 ? A.approxTriangleStats((uint64_t)sampleWedges)
+                                        : A.triangleStats();
+    std::ostringstream oss;
+    oss << "{";
+    oss << "\"triangles\":" << st.triangles << ",";
+    oss << "\"wedges\":" << st.wedges << ",";
+    oss << "\"transitivity\":" << st.transitivity << ",";
+    oss << "\"exact\":" << (st.exact ? "true" : "false") << ",";
+    oss << "\"samples\":" << st.samples << ",";
+    oss << "\"std_error\":" << st.stdError;
+    oss << "}";
+    return cstrdup(oss.str());
+}
+
+char* _api_local_clustering(int userId) {
+    ApiCall call(ApiFn::LocalClustering);
+    long long tri = A.trianglesOf(userId);
+    if (tri < 0) { call.fail(); return cstrdup("null"); }
+    std::ostringstream oss;
+    oss << "{";
+    oss << "\"id\":" << userId << ",";
+    oss << "\"degree\":" << G.degree(userId) << ",";
+    oss << "\"triangles\":" << tri << ",";
+    oss << "\"clustering\":" << A.localClustering(userId);
+    oss << "}";
+    return cstrdup(oss.str());
+}
+
+char* _api_top_clustered(int topN, int minDegree) {
+    ApiCall call(ApiFn::TopClustered);
+    auto top = A.mostClustered(topN, minDegree);
+    std::ostringstream oss;
+    oss << "[";
+    bool first = true;
+    for (auto &p : top) {
+        const User* u = G.getUser(p.first);
+        if (!u) continue;
+        if (!first) oss << ",";
+        oss << "{";
+        oss << "\"id\":" << p.first << ",";
+        oss << "\"name\":\"" << json_escape(u->name) << "\",";
+        oss << "\"degree\":" << G.degree(p.first) << ",";
+        oss << "\"triangles\":" << A.trianglesOf(p.first) << ",";
+        oss << "\"clustering\":" << p.second;
+        oss << "}";
+        first = false;
+    }
+    oss << "]";
+    return cstrdup(oss.str());
+}
+
+// ---------------- influencers ----------------
+char* _api_top_influencers(int topN) {
+    ApiCall call(ApiFn::TopInfluencers);
+    auto top = A.topInfluencers(topN);
+    std::ostringstream oss;
+    oss << "[";
+    bool first = true;
+    for (auto &p : top) {
+        const User* u = G.getUser(p.first);
+        if (!u) continue;
+        if (!first) oss << ",";
+        oss << "{";
+        oss << "\"id\":" << p.first << ",";
+        oss << "\"name\":\"" << json_escape(u->name) << "\",";
+        oss << "\"degree\":" << G.degree(p.first) << ",";
+        oss << "\"score\":" << p.second;
+        oss << "}";
+        first = false;
+    }
+    oss << "]";
+    return cstrdup(oss.str());
+}
+
+char* _api_top_bridges(int samples, int topN) {
+    ApiCall call(ApiFn::TopBridges);
+    auto top = A.approxBetweenness(samples, topN);
+    std::ostringstream oss;
+    oss << "[";
+    bool first = true;
+    for (auto &b : top) {
+        const User* u = G.getUser(b.userId);
+        if (!u) continue;
+        if (!first) oss << ",";
+        oss << "{";
+        oss << "\"id\":" << b.userId << ",";
+        oss << "\"name\":\"" << json_escape(u->name) << "\",";
+        oss << "\"score\":" << b.score << ",";
+        oss << "\"error\":" << b.error << ",";
+        oss << "\"normalized\":" << b.normalized;
+        oss << "}";
+        first = false;
+    }
+    oss << "]";
+    return cstrdup(oss.str());
+}
+
+char* _api_communities(int minSize) {
+    ApiCall call(ApiFn::Communities);
+    const CommunityResult &res = A.detectCommunities();
+    std::ostringstream oss;
+    size_t shown = 0;
+    std::ostringstream list;
+    list << "[";
+    for (auto &c : res.communities) {
+        if ((int)c.size() < minSize) continue;
+        if (shown++) list << ",";
+        list << "[";
+        for (size_t j = 0; j < c.size(); ++j) {
+            if (j) list << ",";
+            list << c[j];
+        }
+        list << "]";
+    }
+    list << "]";
+    oss << "{";
+    oss << "\"modularity\":" << res.modularity << ",";
+    oss << "\"levels\":" << res.levels << ",";
+    oss << "\"count\":" << shown << ",";
+    oss << "\"communities\":" << list.str();
+    oss << "}";
+    return cstrdup(oss.str());
+}
+
+int _api_core_number(int id) {
+    ApiCall call(ApiFn::CoreNumber);
+    return call.check(A.coreNumber(id));
+}
+
+char* _api_k_core(int k) {
+    ApiCall call(ApiFn::KCore);
+    auto members = A.kCore(k);
+    std::ostringstream oss;
+    oss << "{";
+    oss << "\"k\":" << k << ",";
+    oss << "\"maxCore\":" << A.maxCoreNumber() << ",";
+    oss << "\"count\":" << members.size() << ",";
+    oss << "\"members\":[";
+    for (size_t i = 0; i < members.size(); ++i) {
+        if (i) oss << ",";
+        oss << members[i];
+    }
+    oss << "]}";
+    return cstrdup(oss.str());
+}
+
+// ---------------- degrees of separation ----------------
+bool _api_build_distance_index(int landmarks, int rebuildAfter) {
+    ApiCall call(ApiFn::BuildDistanceIndex);
+    if (rebuildAfter > 0) D.setRebuildThreshold((uint64_t)rebuildAfter);
+    return call.check(landmarks > 0 ? D.build(landmarks) : D.build());
+}
+
+char* _api_distance(int a, int b, bool exact) {
+    ApiCall call(ApiFn::Distance);
+    if (!G.userExists(a) || !G.userExists(b)) call.fail();
+    DistanceEstimate est = D.estimate(a, b);
+    int distance = -1;
+    if (exact) distance = D.exactDistance(a, b);
+    else if (est.exact && !est.stale) distance = est.upper;
+    std::ostringstream oss;
+    oss << "{";
+    oss << "\"distance\":" << distance << ",";
+    oss << "\"lower\":" << est.lower << ",";
+    oss << "\"upper\":" << est.upper << ",";
+    oss << "\"exact\":" << (est.exact ? "true" : "false") << ",";
+    oss << "\"stale\":" << (est.stale ? "true" : "false") << ",";
+    oss << "\"indexed\":" << (D.ready() ? "true" : "false");
+    oss << "}";
+    return cstrdup(oss.str());
+}
+
 // ---------------- persistence ----------------
 bool _api_save_network(const char* filename) {
-    if (!filename) return false;
-    return P.saveToFile(std::string(filename));
+    ApiCall call(ApiFn::SaveNetwork);
+    if (!filename) return call.check(false);
+    return call.check(P.saveToFile(std::string(filename)));
 }
 
 bool _api_load_network(const char* filename) {
-    if (!filename) return false;
+    ApiCall call(ApiFn::LoadNetwork);
+    if (!filename) return call.check(false);
+    uint64_t before = G.version();
     bool ok = P.loadFromFile(std::string(filename));
+    // Loading clears the graph first, so even a failed load may need a resync
+    if (G.version() != before) F.record(ChangeType::Reset, 0);
     if (ok) {
         P.rebuildNameIndex();
         T.rebuildTrieFromGraph();
+        D.maybeRebuild();
+    }
+    return call.check(ok);
+}
+
+// ---------------- change feed ----------------
+char* _api_changes_since(long long seq, int maxEvents) {
+    ApiCall call(ApiFn::ChangesSince);
+    if (seq < 0 || maxEvents < 0) { call.fail(); return cstrdup("null"); }
+    ChangeBatch batch = F.since((uint64_t)seq, (size_t)maxEvents);
+    std::ostringstream oss;
+    oss << "{\"next\":" << batch.next << ",\"latest\":" << batch.latest;
+    oss << ",\"overflow\":" << (batch.overflow ? "true" : "false") << ",\"events\":[";
+    for (size_t i = 0; i < batch.events.size(); ++i) {
+        const ChangeEvent &e = batch.events[i];
+        if (i) oss << ",";
+        oss << "{\"seq\":" << e.seq << ",\"type\":\"" << ChangeFeed::typeName(e.type) << "\"";
+        if (e.type == ChangeType::AddFriend || e.type == ChangeType::RemoveFriend)
+            oss << ",\"a\":" << e.a << ",\"b\":" << e.b;
+        else if (e.type != ChangeType::Reset)
+            oss << ",\"id\":" << e.a;
+        oss << "}";
+    }
+    oss << "]}";
+    return cstrdup(oss.str());
+}
+
+// ---------------- diagnostics ----------------
+char* _api_stats() {
+    return cstrdup(ApiStats::toJson());
+}
+
+void _api_stats_reset() {
+    ApiStats::reset();
+}
+
+char* _api_memory_report() {
+    ApiCall call(ApiFn::MemoryReport);
+    MemoryReport report;
+    G.reportMemory(report);
+    P.reportMemory(report);
+    T.reportMemory(report);
+    D.reportMemory(report);
+    return cstrdup(report.toJson());
+}
+
+// Memory vs traversal speed of the delta-varint adjacency on the current snapshot
+char* _api_adjacency_compression(int bfsSources) {
+    ApiCall call(ApiFn::AdjacencyCompression);
+    CompressionReport r = CompressedCsr::compare(*G.snapshot(), bfsSources > 0 ? bfsSources : 4);
+    std::ostringstream oss;
+    oss << "{";
+    oss << "\"nodes\":" << r.nodes << ",";
+    oss << "\"edges\":" << r.edges << ",";
+    oss << "\"csr_bytes\":" << r.csrBytes << ",";
+    oss << "\"compressed_bytes\":" << r.compressedBytes << ",";
+    oss << "\"ratio\":" << (r.compressedBytes ? (double)r.csrBytes / (double)r.compressedBytes : 0.0) << ",";
+    oss << "\"bits_per_edge\":" << r.bitsPerEdge << ",";
+    oss << "\"build_ms\":" << r.buildMs << ",";
+    oss << "\"bfs_ms\":{\"csr\":" << r.csrBfsMs << ",\"compressed\":" << r.compressedBfsMs << "},";
+    oss << "\"intersect_ms\":{\"csr\":" << r.csrIntersectMs << ",\"compressed\":" << r.compressedIntersectMs << "},";
+    oss << "\"consistent\":" << (r.consistent ? "true" : "false") << ",";
+    oss << "\"snapshots_compressed\":" << (G.compressedSnapshots() ? "true" : "false");
+    oss << "}";
+    if (!r.consistent) call.fail();
+    return cstrdup(oss.str());
+}
+
+bool _api_set_compressed_snapshots(bool on) {
+    ApiCall call(ApiFn::SetCompressedSnapshots);
+    G.setCompressedSnapshots(on);
+    return true;
+}
+
+// ---------------- background jobs ----------------
+int _api_submit_job(const char* kind, const char* params) {
+    ApiCall call(ApiFn::SubmitJob);
+    static bool registered = (registerJobKinds(), true);
+    (void)registered;
+    if (!kind) return call.check(-1);
+    return call.check(J.submit(kind, params ? params : "", G.snapshot()));
+}
+
+char* _api_job_status(int jobId) {
+    ApiCall call(ApiFn::JobStatus);
+    JobInfo info;
+    std::ostringstream oss;
+    if (!J.info(jobId, info)) {
+        call.fail();
+        oss << "{\"id\":" << jobId << ",\"status\":\"unknown\"}";
+        return cstrdup(oss.str());
     }
-    return ok;
+    oss << "{";
+    oss << "\"id\":" << info.id << ",";
+    oss << "\"kind\":\"" << json_escape(info.kind) << "\",";
+    oss << "\"status\":\"" << JobManager::statusName(info.status) << "\",";
+    oss << "\"queued_ms\":" << info.queuedMs << ",";
+    oss << "\"run_ms\":" << info.runMs;
+    if (!info.error.empty()) oss << ",\"error\":\"" << json_escape(info.error) << "\"";
+    oss << "}";
+    return cstrdup(oss.str());
+}
+
+bool _api_job_cancel(int jobId) {
+    ApiCall call(ApiFn::JobCancel);
+    return call.check(J.cancel(jobId));
+}
+
+char* _api_job_result(int jobId) {
+    ApiCall call(ApiFn::JobResult);
+    std::string out;
+    if (!J.result(jobId, out)) {
+        call.fail();
+        return cstrdup("null");
+    }
+    return cstrdup(out);
+}
+
+// ---------------- thread pool ----------------
+int _api_set_worker_count(int workers) {
+    ApiCall call(ApiFn::SetWorkerCount);
+    if (workers < 0) return call.check(-1);
+    setParallelWorkers((unsigned)workers);
+    return (int)parallelWorkers();
+}
+
+char* _api_thread_pool_info() {
+    ApiCall call(ApiFn::ThreadPoolInfo);
+    ThreadPool &pool = ThreadPool::instance();
+    std::ostringstream oss;
+    oss << "{";
+    oss << "\"workers\":" << pool.size() << ",";
+    oss << "\"hardware\":" << std::thread::hardware_concurrency() << ",";
+    oss << "\"tasks_executed\":" << pool.tasksExecuted() << ",";
+    oss << "\"tasks_stolen\":" << pool.tasksStolen();
+    oss << "}";
+    return cstrdup(oss.str());
 }
 
 // free helper
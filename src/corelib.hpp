@@ -8,6 +8,7 @@ int _api_add_user(const char* name);
 int _api_add_user_with_id(const char* name, int fixedId);
 bool _api_add_friend(int a, int b);
 bool _api_remove_friend(int a, int b);
+int _api_add_friends_bulk(const int* pairs, int pairCount); // new friendships, or -1
 bool _api_remove_user(int id);
 
 // Interests
@@ -19,14 +20,78 @@ char* _api_list_all_users();
 char* _api_print_user_info(int id);
 char* _api_recommend_mutual(int userId, int topK);
 char* _api_recommend_weighted(int userId, int topK);
+// strategy: mutual, weighted, adamic_adar, resource_allocation, jaccard,
+// preferential_attachment
+char* _api_recommend_scored(int userId, int topK, const char* strategy);
+// Same, skipping excluded ids (csv) and users lacking any required interest (csv);
+// filters apply before the top-K cut, so up to topK valid results come back
+char* _api_recommend_filtered(int userId, int topK, const char* strategy,
+                              const char* excludeCsv, const char* interestsCsv);
+
+// Batch recommendations, streamed in chunks: userIdsCsv NULL or "" means all
+// users; next() returns "[]" once every user has been returned
+int _api_recommend_batch_begin(const char* userIdsCsv, int topK, int chunkSize);
+char* _api_recommend_batch_next(int cursor);
+bool _api_recommend_batch_end(int cursor);
+
+// Recommendation result cache (capacity 0 disables it)
+char* _api_recommend_cache_stats();
+bool _api_recommend_cache_capacity(int entries);
 char* _api_shortest_path(int src, int dst);
 char* _api_connected_components();
 char* _api_suggest_prefix(const char* prefix, int k);
+// Interest search: all/any/none are comma-separated interests (NULL or "" = no terms)
+char* _api_search_interests(const char* allCsv, const char* anyCsv, const char* noneCsv, int topK);
+
+// Triangles / clustering (sampleWedges <= 0 means exact)
+char* _api_triangle_stats(int sampleWedges);
+char* _api_local_clustering(int userId);
+char* _api_top_clustered(int topN, int minDegree);
+
+// PageRank influencers
+char* _api_top_influencers(int topN);
+
+// Sampled betweenness ("bridge" users)
+char* _api_top_bridges(int samples, int topN);
+char* _api_communities(int minSize);
+int _api_core_number(int id);
+char* _api_k_core(int k);
+char* _api_recommend_random_walk(int userId, int topK, int walks);
+bool _api_build_distance_index(int landmarks, int rebuildAfter);
+char* _api_distance(int a, int b, bool exact);
+
+// Thread pool (workers include the calling thread; 0 = hardware default)
+int _api_set_worker_count(int workers);
+char* _api_thread_pool_info();
+
+// Background jobs: kind is components | communities | pagerank | triangles |
+// betweenness | kcore; params are "key=value" pairs joined by '&'
+int _api_submit_job(const char* kind, const char* params);
+char* _api_job_status(int jobId);
+bool _api_job_cancel(int jobId);
+char* _api_job_result(int jobId);
+
+// Change feed: mutations after sequence number `seq` (0 = from the start),
+// at most maxEvents of them. "overflow":true means events were lost and the
+// caller should resync, then continue from "next"
+char* _api_changes_since(long long seq, int maxEvents);
 
 // Persistence
 bool _api_save_network(const char* filename);
 bool _api_load_network(const char* filename);
 
+// Diagnostics (API latency stats, memory footprint)
+char* _api_stats();
+void _api_stats_reset();
+char* _api_memory_report();
+// Builds the delta-varint compressed adjacency for the current graph and
+// reports its memory and BFS/intersection time against the plain CSR
+char* _api_adjacency_compression(int bfsSources);
+// Switches the cached graph snapshot between the plain CSR and the
+// compressed adjacency; components, shortest paths and mutual counts
+// then run on the compressed form
+bool _api_set_compressed_snapshots(bool on);
+
 // Memory free helper
 void _api_free_string(char* s);
 
@@ -197,12 +197,7 @@ int main()
                     if (!cand || !target) continue;
 
                     // Count mutuals
-                    auto f1 = graph.getFriends(id);
-                    auto f2 = graph.getFriends(candId);
-                    int mutuals = 0;
-                    for (int a : f1)
-                        for (int b : f2)
-                            if (a == b) mutuals++;
+                    size_t mutuals = graph.mutualCount(id, candId);
 
                     // Shared interests
                     std::vector<std::string> shared;
@@ -0,0 +1,26 @@
+#include "CoreGraph.h"
+#include "Check.h"
+#include <cstdio>
+#include <utility>
+#include <vector>
+
+int main() {
+    CoreGraph g;
+    for (int id = 1; id <= 5; ++id) g.addUser("u", id);
+    g.addFriend(1, 2);
+    uint64_t before = g.version();
+
+    // Existing, duplicate, reversed, self and dangling pairs are not reported
+    std::vector<std::pair<int, int>> edges = {{2, 1}, {3, 1}, {1, 3}, {4, 4}, {5, 9}, {5, 4}, {2, 3}};
+    auto inserted = g.addFriendsBulk(edges);
+    std::vector<std::pair<int, int>> expected = {{1, 3}, {2, 3}, {4, 5}};
+    CHECK(inserted == expected);
+    CHECK(g.version() == before + 3);
+    CHECK(g.areFriends(3, 1) && g.areFriends(4, 5) && g.degree(3) == 2);
+
+    CHECK(g.addFriendsBulk(edges).empty());
+    CHECK(g.version() == before + 3);
+
+    std::printf("BulkFriendsTest: OK\n");
+    return 0;
+}
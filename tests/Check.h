@@ -0,0 +1,16 @@
+#ifndef CHECK_H
+#define CHECK_H
+
+#include <cstdio>
+#include <cstdlib>
+
+// Prints the failed condition with its location and exits with status 1
+#define CHECK(cond)                                                   \
+    do {                                                              \
+        if (!(cond)) {                                                \
+            std::printf("%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+            std::exit(1);                                             \
+        }                                                             \
+    } while (0)
+
+#endif // CHECK_H
@@ -0,0 +1,76 @@
+#include "CoreGraph.h"
+#include "CsrGraph.h"
+#include "CompressedCsr.h"
+#include "GraphAlgorithms.h"
+#include "MemoryReport.h"
+#include "Check.h"
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <vector>
+
+int main() {
+    // Random sparse graph with a few isolated users and scattered ids
+    CoreGraph g;
+    std::vector<int> ids;
+    for (int i = 0; i < 3000; ++i) {
+        ids.push_back(1 + i * 7);
+        g.addUser("u", ids.back());
+    }
+    std::mt19937 rng(5);
+    for (int i = 0; i < 6000; ++i) {
+        int a = ids[rng() % 2900], b = ids[rng() % 2900];
+        if (a != b) g.addFriend(a, b);
+    }
+    GraphAlgorithms algo(&g);
+
+    auto plainComponents = algo.connectedComponents();
+    auto plainPath = algo.shortestPath(ids[0], ids[1234]);
+    std::vector<size_t> plainMutuals;
+    for (int i = 0; i < 200; ++i) plainMutuals.push_back(algo.mutualCount(ids[i], ids[i + 1]));
+
+    g.setCompressedSnapshots(true);
+    CHECK(g.compressedSnapshots());
+
+    // The compressed snapshot matches the plain one of the same version
+    auto packed = g.compressedSnapshot();
+    auto plain = CsrGraph::build(g);
+    CHECK(packed->version() == g.version() && packed->numNodes() == plain->numNodes());
+    for (int u = 0; u < plain->numNodes(); ++u) {
+        CHECK(packed->idOf(u) == plain->idOf(u) && packed->degree(u) == plain->degree(u));
+        std::vector<int> row(packed->degree(u));
+        packed->decode(u, row.data());
+        CHECK(std::vector<int>(plain->begin(u), plain->end(u)) == row);
+    }
+    CHECK(g.compressedSnapshot() == packed);
+
+    // Kernels give the same answers on it
+    CHECK(algo.connectedComponents() == plainComponents);
+    auto path = algo.shortestPath(ids[0], ids[1234]);
+    CHECK(path.size() == plainPath.size() && path.front() == ids[0] && path.back() == ids[1234]);
+    for (size_t i = 1; i < path.size(); ++i) CHECK(g.areFriends(path[i - 1], path[i]));
+    for (int i = 0; i < 200; ++i) CHECK(algo.mutualCount(ids[i], ids[i + 1]) == plainMutuals[i]);
+    CHECK(algo.shortestPath(ids[0], ids[2999]).empty());
+
+    // The plain CSR is only kept while someone holds it
+    auto held = g.snapshot();
+    CHECK(g.snapshot() == held);
+    std::weak_ptr<const CsrGraph> weak = held;
+    held.reset();
+    CHECK(weak.expired());
+
+    // Writes publish a new compressed snapshot
+    g.addFriend(ids[0], ids[2999]);
+    CHECK(g.compressedSnapshot() != packed);
+    CHECK(algo.shortestPath(ids[0], ids[2999]).size() == 2);
+
+    MemoryReport report;
+    g.reportMemory(report);
+    CHECK(report.toJson().find("graph.compressed_snapshot") != std::string::npos);
+
+    g.setCompressedSnapshots(false);
+    CHECK(algo.connectedComponents().size() == plainComponents.size() - 1);
+
+    std::printf("CompressedSnapshotTest: OK\n");
+    return 0;
+}
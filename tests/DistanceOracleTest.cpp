@@ -0,0 +1,36 @@
+#include "DistanceOracle.h"
+#include "CoreGraph.h"
+#include "Check.h"
+#include <cstdio>
+#include <thread>
+
+int main() {
+    // Path 1 - 2 - ... - 10
+    CoreGraph g;
+    for (int id = 1; id <= 10; ++id) g.addUser("u", id);
+    for (int id = 1; id < 10; ++id) g.addFriend(id, id + 1);
+
+    DistanceOracle oracle(&g);
+    CHECK(oracle.build(2));
+    CHECK(oracle.exactDistance(1, 10) == 9);
+    CHECK(!oracle.estimate(1, 10).stale);
+
+    // After writes the index is stale and the answer comes from the live graph
+    g.addFriend(1, 10);
+    CHECK(oracle.estimate(1, 10).stale);
+    CHECK(oracle.exactDistance(1, 10) == 1);
+    CHECK(oracle.exactDistance(2, 9) == 3);
+    g.addUser("v", 11);
+    CHECK(oracle.exactDistance(1, 11) == -1);
+    g.addFriend(11, 5);
+    CHECK(oracle.exactDistance(1, 11) == 5);
+
+    // A rebuild catches up with the graph
+    oracle.rebuildAsync();
+    while (oracle.rebuilding()) std::this_thread::yield();
+    CHECK(!oracle.estimate(1, 11).stale);
+    CHECK(oracle.exactDistance(1, 11) == 5);
+
+    std::printf("DistanceOracleTest: OK\n");
+    return 0;
+}
@@ -0,0 +1,67 @@
+#include "JobManager.h"
+#include "CoreGraph.h"
+#include "CsrGraph.h"
+#include "GraphAlgorithms.h"
+#include "Check.h"
+#include <chrono>
+#include <cstdio>
+#include <stdexcept>
+#include <thread>
+
+static JobStatus waitFor(JobManager &jobs, int id) {
+    JobInfo info;
+    for (int i = 0; i < 6000; ++i) {
+        CHECK(jobs.info(id, info));
+        if (info.status != JobStatus::Queued && info.status != JobStatus::Running) return info.status;
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    CHECK(false);
+    return info.status;
+}
+
+int main() {
+    CoreGraph g;
+    for (int id = 1; id <= 2000; ++id) g.addUser("u", id);
+    for (int id = 2; id <= 2000; ++id) g.addFriend(id, id / 2);
+    auto snap = g.snapshot();
+
+    JobManager jobs;
+
+    // A throwing kind fails the job instead of terminating the process
+    jobs.registerKind("throws", [](const JobContext &) -> std::string {
+        throw std::runtime_error("bad parameter");
+    });
+    int failed = jobs.submit("throws", "", snap);
+    CHECK(waitFor(jobs, failed) == JobStatus::Failed);
+    JobInfo info;
+    CHECK(jobs.info(failed, info) && info.error == "bad parameter");
+
+    // Kernels stop at the next check once cancel is requested
+    jobs.registerKind("betweenness", [](const JobContext &ctx) -> std::string {
+        auto top = GraphAlgorithms::betweennessOf(ctx.graph, 1 << 30, 10, 1, &ctx.cancelRequested);
+        return ctx.cancelled() ? "" : "{}";
+    });
+    int slow = jobs.submit("betweenness", "", snap);
+    while (jobs.info(slow, info) && info.status == JobStatus::Queued) std::this_thread::yield();
+    CHECK(jobs.cancel(slow));
+    CHECK(waitFor(jobs, slow) == JobStatus::Cancelled);
+
+    // Destroying the manager stops a running job instead of waiting it out
+    auto started = std::chrono::steady_clock::now();
+    {
+        JobManager scoped;
+        scoped.registerKind("spin", [](const JobContext &ctx) -> std::string {
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+            while (!ctx.cancelled() && std::chrono::steady_clock::now() < deadline)
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            return "{}";
+        });
+        int spin = scoped.submit("spin", "", snap);
+        while (scoped.info(spin, info) && info.status == JobStatus::Queued) std::this_thread::yield();
+        CHECK(info.status == JobStatus::Running);
+    }
+    CHECK(std::chrono::steady_clock::now() - started < std::chrono::seconds(5));
+
+    std::printf("JobManagerTest: OK\n");
+    return 0;
+}
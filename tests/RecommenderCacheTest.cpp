@@ -0,0 +1,50 @@
+#include "CoreGraph.h"
+#include "Recommender.h"
+#include "Check.h"
+#include <cstdio>
+
+// 1 - {2, 3}; 2 - 4; 3 - 5: candidates 4 and 5 have one mutual friend each
+static void buildGraph(CoreGraph &g) {
+    for (int id = 1; id <= 7; ++id) g.addUser("u" + std::to_string(id), id);
+    g.addFriend(1, 2);
+    g.addFriend(1, 3);
+    g.addFriend(2, 4);
+    g.addFriend(3, 5);
+}
+
+// Growing a candidate's degree touches neither user 1 nor its friends,
+// yet must change degree-based rankings on the next call
+static void candidateDegreeChange(RecStrategy strategy) {
+    CoreGraph g;
+    buildGraph(g);
+    Recommender r(&g);
+
+    auto before = r.recommendDetailed(1, 2, strategy);
+    CHECK(before.size() == 2);
+    CHECK(r.recommendDetailed(1, 2, strategy)[0].score == before[0].score);
+
+    g.addFriend(5, 6);
+    g.addFriend(5, 7);
+    auto after = r.recommendDetailed(1, 2, strategy);
+    CHECK(after.size() == 2);
+    double score5 = after[0].userId == 5 ? after[0].score : after[1].score;
+    double old5 = before[0].userId == 5 ? before[0].score : before[1].score;
+    CHECK(score5 != old5);
+    if (strategy == RecStrategy::PreferentialAttachment) CHECK(after[0].userId == 5);
+}
+
+int main() {
+    candidateDegreeChange(RecStrategy::Jaccard);
+    candidateDegreeChange(RecStrategy::PreferentialAttachment);
+
+    // Mutual counts only depend on the two-hop neighborhood and stay cached
+    CoreGraph g;
+    buildGraph(g);
+    Recommender r(&g);
+    r.recommendDetailed(1, 2, RecStrategy::Mutual);
+    r.recommendDetailed(1, 2, RecStrategy::Mutual);
+    CHECK(r.cacheStats().hits == 1);
+
+    std::printf("RecommenderCacheTest: OK\n");
+    return 0;
+}
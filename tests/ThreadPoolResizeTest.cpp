@@ -0,0 +1,43 @@
+#include "Parallel.h"
+#include "Check.h"
+#include <atomic>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+// Background threads keep running loops with per-worker scratch while the
+// main thread resizes the pool underneath them
+int main() {
+    std::atomic<bool> done(false);
+    auto loops = [&]() {
+        while (!done.load()) {
+            ParallelScope scope;
+            std::vector<size_t> perWorker(scope.workers(), 0);
+            parallelFor(0, 10000, 64, [&](size_t lo, size_t hi, unsigned worker) {
+                CHECK(worker < perWorker.size());
+                perWorker[worker] += hi - lo;
+            });
+            size_t sum = 0;
+            for (size_t s : perWorker) sum += s;
+            CHECK(sum == 10000);
+            size_t total = parallelReduce(0, 10000, 64, (size_t)0,
+                                          [](size_t lo, size_t hi) { return hi - lo; },
+                                          [](size_t a, size_t b) { return a + b; });
+            CHECK(total == 10000);
+        }
+    };
+    std::thread a(loops), b(loops);
+    for (int i = 0; i < 200; ++i) setParallelWorkers(1 + i % 5);
+
+    // Resizing from inside a loop would wait on itself; it is refused
+    parallelFor(0, 2, 1, [](size_t, size_t, unsigned) {
+        CHECK(!ThreadPool::instance().resize(2));
+    });
+
+    done = true;
+    a.join();
+    b.join();
+    setParallelWorkers(0);
+    std::printf("ThreadPoolResizeTest: OK\n");
+    return 0;
+}